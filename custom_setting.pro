@@ -1,4 +1,4 @@
-QT += widgets
+QT += widgets concurrent sql
 
 TEMPLATE = lib
 CONFIG += staticlib c++17
@@ -6,24 +6,42 @@ DESTDIR = ../bin
 
 SOURCES += \
     src/custom_setting.cpp \
+    src/custom_setting_arena.cpp \
+    src/custom_setting_atomic_file.cpp \
+    src/custom_setting_builder.cpp \
+    src/custom_setting_compression.cpp \
     src/custom_setting_data.cpp \
     src/custom_setting_item.cpp \
     src/custom_setting_item_delegate.cpp \
     src/custom_setting_item_tree_model.cpp \
+    src/custom_setting_journal.cpp \
+    src/custom_setting_json_writer.cpp \
     src/custom_setting_manager.cpp \
+    src/custom_setting_schema.cpp \
     src/custom_setting_serializer.cpp \
+    src/custom_setting_serializer_cache.cpp \
+    src/custom_setting_snapshot.cpp \
     src/custom_setting_tree_widget.cpp \
     src/custom_setting_widget.cpp \
     src/custom_widgets.cpp
 
 HEADERS += \
     inc/custom_setting.h \
+    inc/custom_setting_arena.h \
+    inc/custom_setting_atomic_file.h \
+    inc/custom_setting_builder.h \
+    inc/custom_setting_compression.h \
     inc/custom_setting_data.h \
     inc/custom_setting_item.h \
     inc/custom_setting_item_delegate.h \
     inc/custom_setting_item_tree_model.h \
+    inc/custom_setting_journal.h \
+    inc/custom_setting_json_writer.h \
     inc/custom_setting_manager.h \
+    inc/custom_setting_schema.h \
     inc/custom_setting_serializer.h \
+    inc/custom_setting_serializer_cache.h \
+    inc/custom_setting_snapshot.h \
     inc/custom_setting_tree_widget.h \
     inc/custom_setting_widget.h \
     inc/custom_widgets.h
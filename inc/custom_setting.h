@@ -2,13 +2,66 @@
 
 #include <QSettings>
 #include <functional>
+#include <memory>
+#include <type_traits>
 #include "custom_setting_data.h"
 #include "custom_setting_manager.h"
+#include "custom_setting_schema.h"
+#include "custom_setting_serializer.h"
 
 namespace custom_setting
 {
 
-class Serializer;
+enum class SettingTypeId : quint8
+{
+    kUnknown,
+    kInt,
+    kUInt,
+    kDouble,
+    kBool,
+    kString,
+    kStringList,
+    kCheckList,
+    kByteArray,
+    kFont,
+    kColor,
+    kSource,
+    kDateTime,
+    kEditableStringList,
+    kCheckableStringList,
+    kChangeableStringList,
+    kCount
+};
+
+template <typename T>
+struct SettingTypeIdTraits
+{
+    static constexpr SettingTypeId kTypeId = SettingTypeId::kUnknown;
+};
+
+template <SettingTypeId typeId>
+struct SettingTypeIdValue
+{
+    static constexpr SettingTypeId kTypeId = typeId;
+};
+
+template <> struct SettingTypeIdTraits<DataInteger>              : SettingTypeIdValue<SettingTypeId::kInt> {};
+template <> struct SettingTypeIdTraits<DataUnsigned>             : SettingTypeIdValue<SettingTypeId::kUInt> {};
+template <> struct SettingTypeIdTraits<DataDouble>               : SettingTypeIdValue<SettingTypeId::kDouble> {};
+template <> struct SettingTypeIdTraits<DataBool>                 : SettingTypeIdValue<SettingTypeId::kBool> {};
+template <> struct SettingTypeIdTraits<DataStringMask>           : SettingTypeIdValue<SettingTypeId::kString> {};
+template <> struct SettingTypeIdTraits<DataStringList>           : SettingTypeIdValue<SettingTypeId::kStringList> {};
+template <> struct SettingTypeIdTraits<DataCheckList>            : SettingTypeIdValue<SettingTypeId::kCheckList> {};
+template <> struct SettingTypeIdTraits<DataByteArray>            : SettingTypeIdValue<SettingTypeId::kByteArray> {};
+template <> struct SettingTypeIdTraits<DataFont>                 : SettingTypeIdValue<SettingTypeId::kFont> {};
+template <> struct SettingTypeIdTraits<DataColor>                : SettingTypeIdValue<SettingTypeId::kColor> {};
+template <> struct SettingTypeIdTraits<DataSource>               : SettingTypeIdValue<SettingTypeId::kSource> {};
+template <> struct SettingTypeIdTraits<DataDateTime>             : SettingTypeIdValue<SettingTypeId::kDateTime> {};
+template <> struct SettingTypeIdTraits<DataEditableStringList>   : SettingTypeIdValue<SettingTypeId::kEditableStringList> {};
+template <> struct SettingTypeIdTraits<DataCheckableStringList>  : SettingTypeIdValue<SettingTypeId::kCheckableStringList> {};
+template <> struct SettingTypeIdTraits<DataChangeableStringList> : SettingTypeIdValue<SettingTypeId::kChangeableStringList> {};
+
+class SettingArena;
 
 class Setting : public QObject
 {
@@ -17,19 +70,27 @@ class Setting : public QObject
  public:
     using Vector = QVector<Setting*>;
 
+    static constexpr SettingTypeId kTypeId = SettingTypeId::kUnknown;
+
     Setting(const QString& key,
             const QString& caption,
             const QString& description,
             bool readOnly = false,
             QObject* parent = nullptr);
 
-    virtual ~Setting() = default;
+    virtual ~Setting();
+
+    static void* operator new(std::size_t size);
+    static void operator delete(void* memory);
 
     void addSettings(const Vector& settings);
     void bindTo(std::function<void(const QVariant&)> handler);
     void bindTo(std::function<void(void)> handler);
     void blockHandler(bool isBlocked);
 
+    const QString& getKey() const;
+    const KeyPath& getKeyPath() const;
+
     const QString& getCaption() const;
     void setCaption(const QString& caption);
 
@@ -43,29 +104,111 @@ class Setting : public QObject
     virtual QVariant getDefaultValue() const;
 
     const Vector& getSettings() const;
+    Setting* getParentSetting() const;
+    Manager* getManager() const;
+    SettingTypeId getTypeId() const;
     bool isReadOnly() const;
+    bool isDirty() const;
     virtual bool isAnyChecked() const;
 
+    void setLazyLoad(bool isLazyLoad);
+    bool isLazyLoad() const;
+
 signals:
     void signalDataChanged(const QVariant&);
+    void signalSettingChanged(Setting* setting);
+    void signalTransactionCommitted(const QStringList& keys);
 
 protected:
     void emitSignalDataChanged(const QVariant& value);
+    void markDirty();
+    void ensureLoaded() const;
+    void cancelPendingLoad();
+    virtual void loadValue(const QVariant& value);
+    virtual void readValue(Serializer& serializer, bool isSilent);
+    void setParentSetting(Setting* parent);
+    virtual void updateKeyPath();
+    virtual void setManager(Manager* manager);
 
 protected:
     Vector mSettings;
+    Setting* mParentSetting{nullptr};
+    Manager* mManager{nullptr};
+    KeyPath mKeyPath;
     QString mKey;
     QString mCaption;
     QString mDescription;
     bool mReadOnly;
     bool mIsHandlerBlocked{false};
+    bool mIsValueDirty{false};
+    bool mIsTreeDirty{false};
+    bool mIsLazyLoad{false};
+    bool mIsKeyRoot{false};
+    SettingTypeId mTypeId{SettingTypeId::kUnknown};
 
 private:
-    virtual void load(Serializer* serializer, const QString& parentKey = {});
-    virtual void save(Serializer* serializer, const QString& parentKey = {});
+    std::shared_ptr<Serializer> mPendingSerializer;
+
+private:
+    virtual void load(const std::shared_ptr<Serializer>& serializer);
+    void reload(const std::shared_ptr<Serializer>& serializer);
+    void deferLoad(const std::shared_ptr<Serializer>& serializer);
+    void loadPending();
+    virtual void save(Serializer* serializer, bool isDirtyOnly = false);
     bool getIsHandlerBlocked() const;
+    void clearDirty();
+    void setKeyRoot(bool isKeyRoot);
+
+    static void* operator new(std::size_t size, SettingArena& arena);
+    static void operator delete(void* memory, SettingArena& arena);
 
 friend Manager;
+friend SettingArena;
+};
+
+template <typename T>
+class ValueReader : public ValueVisitor
+{
+public:
+    explicit ValueReader(const T& value) :
+        mValue(value)
+    {}
+
+    void visit(bool value) override { assign(value); }
+    void visit(qint64 value) override { assign(value); }
+    void visit(double value) override { assign(value); }
+    void visit(QString&& value) override { assign(std::move(value)); }
+    void visit(QStringList&& value) override { assign(std::move(value)); }
+    void visit(QByteArray&& value) override { assign(std::move(value)); }
+    void visit(QVariant&& value) override { mValue = value.value<T>(); }
+
+    T& getValue() { return mValue; }
+
+private:
+    T mValue;
+
+    template <typename U>
+    void assign(U&& value)
+    {
+        using ValueType = std::decay_t<U>;
+
+        if constexpr (std::is_same<T, ValueType>::value)
+        {
+            mValue = std::forward<U>(value);
+        }
+        else if constexpr (std::is_integral<T>::value && std::is_floating_point<ValueType>::value)
+        {
+            mValue = T(qRound64(value));
+        }
+        else if constexpr (std::is_arithmetic<T>::value && std::is_arithmetic<ValueType>::value)
+        {
+            mValue = T(value);
+        }
+        else
+        {
+            mValue = QVariant::fromValue(value).template value<T>();
+        }
+    }
 };
 
 template <typename T>
@@ -74,6 +217,8 @@ class SettingExt : public Setting
     using DataValueType = typename T::ValueType;
 
 public:
+    static constexpr SettingTypeId kTypeId = SettingTypeIdTraits<T>::kTypeId;
+
     SettingExt(const QString& key,
                const QString& caption,
                const QString& description,
@@ -81,17 +226,25 @@ public:
                bool readOnly = false,
                QObject* parent = nullptr) :
         Setting(key, caption, description, readOnly, parent),
-        mData(data)
-    {}
+        mValue(data.value),
+        mResetValue(makeResetValue(data)),
+        mData(makeSchema(data))
+    {
+        mTypeId = kTypeId;
+    }
 
     SettingExt(const SettingExt<T>& setting, QObject* parent = nullptr) :
-        Setting(setting.mKey,
-                setting.mCaption,
-                setting.mDescription,
+        Setting(setting.getKey(),
+                setting.getCaption(),
+                setting.getDescription(),
                 setting.mReadOnly,
                 parent),
+        mValue(setting.getDataValue()),
+        mResetValue(setting.mResetValue ? new DataValueType(*setting.mResetValue) : nullptr),
         mData(setting.mData)
-    {}
+    {
+        mTypeId = kTypeId;
+    }
 
     SettingExt(const T& data, bool readOnly = false, QObject* parent = nullptr)
         : SettingExt<T>::SettingExt("", "", "", data, readOnly, parent)
@@ -103,31 +256,56 @@ public:
 
     void setData(const T& data)
     {
-        mData = data;
+        cancelPendingLoad();
+        mData = makeSchema(data);
+        mResetValue = makeResetValue(data);
+        mValue = data.value;
+        markDirty();
     }
 
-    T& getData()
+    // Returns a copy; change it through setData() or setDataValue().
+    const T getData() const
     {
-        return mData;
+        ensureLoaded();
+
+        auto data = *mData;
+        data.value = mValue;
+
+        if (mResetValue)
+        {
+            data.resetValue = *mResetValue;
+        }
+
+        return data;
+    }
+
+    // Shared limits and lists; value and resetValue hold the default here.
+    const T& getSchema() const
+    {
+        return *mData;
     }
 
     void setDataValue(DataValueType value)
     {
-        if (mData.value != value)
+        cancelPendingLoad();
+
+        if (mValue != value)
         {
-            mData.value = value;
+            mValue = value;
+            markDirty();
             emitSignalDataChanged(value);
         }
     }
 
     DataValueType getDataValue() const
     {
-        return mData.value;
+        ensureLoaded();
+        return mValue;
     }
 
     DataValueType getDataDefaultValue() const
     {
-        return mData.defaultValue;
+        return mData->defaultValue;
     }
 
     void setValue(const QVariant& variant) override
@@ -167,12 +345,58 @@ public:
         mCaption = setting.mCaption;
         mDescription = setting.mDescription;
         mReadOnly = setting.mReadOnly;
-        setDataValue(setting.mData);
+        mData = setting.mData;
+        mResetValue.reset(setting.mResetValue ? new DataValueType(*setting.mResetValue) : nullptr);
+        updateKeyPath();
+        setDataValue(setting.getDataValue());
         return *this;
     }
 
+protected:
+    void loadValue(const QVariant& variant) override
+    {
+        mValue = variant.value<DataValueType>();
+    }
+
+    void readValue(Serializer& serializer, bool isSilent) override
+    {
+        ValueReader<DataValueType> reader(mData->defaultValue);
+        serializer.readValue(mKeyPath, reader);
+
+        if (isSilent)
+        {
+            mValue = std::move(reader.getValue());
+        }
+        else if (mValue != reader.getValue())
+        {
+            mValue = std::move(reader.getValue());
+            markDirty();
+            emitSignalDataChanged(mValue);
+        }
+    }
+
 private:
-    T mData;
+    // Only library data types have an exact operator==; other types get a private descriptor.
+    using Schema = SharedSchema<T, kTypeId != SettingTypeId::kUnknown>;
+
+    DataValueType mValue;
+    std::unique_ptr<DataValueType> mResetValue;
+    Schema mData;
+
+    static Schema makeSchema(T data)
+    {
+        data.value = data.defaultValue;
+        data.resetValue = data.defaultValue;
+
+        return Schema(data);
+    }
+
+    static std::unique_ptr<DataValueType> makeResetValue(const T& data)
+    {
+        return std::unique_ptr<DataValueType>(data.resetValue != data.defaultValue
+                                                  ? new DataValueType(data.resetValue)
+                                                  : nullptr);
+    }
 };
 
 using SettingInt                  = SettingExt<DataInteger>;
@@ -191,4 +415,29 @@ using SettingEditableStringList   = SettingExt<DataEditableStringList>;
 using SettingCheckableStringList  = SettingExt<DataCheckableStringList>;
 using SettingChangeableStringList = SettingExt<DataChangeableStringList>;
 
+template <typename T>
+struct IsSettingExt : std::false_type {};
+
+template <typename D>
+struct IsSettingExt<SettingExt<D>> : std::true_type {};
+
+// Subclasses inherit kTypeId, so only SettingExt<D> itself may take the static path.
+template <typename T>
+T* settingCast(Setting* setting)
+{
+    if (!setting)
+    {
+        return nullptr;
+    }
+
+    if constexpr (IsSettingExt<T>::value && T::kTypeId != SettingTypeId::kUnknown)
+    {
+        return setting->getTypeId() == T::kTypeId ? static_cast<T*>(setting) : nullptr;
+    }
+    else
+    {
+        return dynamic_cast<T*>(setting);
+    }
+}
+
 }  // namespace custom_setting
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "custom_setting.h"
+
+namespace custom_setting {
+
+class SettingArena
+{
+public:
+    SettingArena() = default;
+    ~SettingArena();
+
+    SettingArena(const SettingArena&) = delete;
+    SettingArena& operator=(const SettingArena&) = delete;
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args)
+    {
+        static_assert(std::is_base_of<Setting, T>::value, "SettingArena only holds settings");
+        static_assert(alignof(T) <= kArenaTag, "Setting is over-aligned for the arena");
+
+        auto setting = new (*this) T(std::forward<Args>(args)...);
+        attach(setting, setting);
+
+        return setting;
+    }
+
+    void clear();
+    int getSize() const;
+    std::size_t getCapacity() const;
+
+    static void* allocate(std::size_t size, SettingArena* arena);
+    static void deallocate(void* memory);
+
+private:
+    // Heap settings are aligned to the default new alignment, arena settings are
+    // offset by half of it, so deallocate() tells them apart by this address bit.
+    static constexpr std::size_t kArenaTag = __STDCPP_DEFAULT_NEW_ALIGNMENT__ / 2;
+
+    struct Block
+    {
+        std::unique_ptr<char[]> memory;
+        std::size_t used;
+    };
+
+    std::vector<Block> mBlocks;
+    std::size_t mBlockIndex{0};
+    std::size_t mCapacity{0};
+    int mSize{0};
+
+private:
+    void* allocateBlock(std::size_t size);
+    static void attach(void* memory, Setting* setting);
+};
+
+} // namespace custom_setting
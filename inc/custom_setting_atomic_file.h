@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QFile>
+#include <memory>
+#include "custom_setting_compression.h"
+#include "custom_setting_serializer.h"
+
+namespace custom_setting {
+
+class AtomicFile
+{
+public:
+    AtomicFile(const QString& filename, Serializer::SyncPolicy policy);
+    ~AtomicFile();
+
+    void setCompressionLevel(int level);
+    bool open();
+    bool commit();
+    QIODevice* getDevice();
+
+private:
+    QString mFilename;
+    QFile mFile;
+    std::unique_ptr<CompressedDevice> mCompressedDevice;
+    Serializer::SyncPolicy mPolicy;
+    int mCompressionLevel{0};
+    bool mIsCommitted{false};
+
+private:
+    bool syncFile();
+    bool syncDirectory() const;
+    bool replaceTarget();
+};
+
+} // namespace custom_setting
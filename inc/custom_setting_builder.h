@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QVariant>
+#include <vector>
+#include "custom_setting.h"
+
+namespace custom_setting {
+
+class Item;
+class SettingArena;
+
+struct SettingDeclaration
+{
+    SettingTypeId typeId{SettingTypeId::kUnknown};
+    QString key;
+    QString caption;
+    QString description;
+    QVariant value;
+    QVariant defaultValue;
+    QVariant list;
+    QVariant minimum;
+    QVariant maximum;
+    QVariant decimals;
+    QString suffix;
+    QString filters;
+    QString validator;
+    DataSource::SourceType sourceType{DataSource::kFile};
+    DataChangeableStringList::ListType listType{DataChangeableStringList::kStringList};
+    bool isUniqItems{false};
+    bool readOnly{false};
+    std::vector<SettingDeclaration> children;
+};
+
+class SettingBuilder
+{
+public:
+    static Item* build(const SettingDeclaration& declaration, SettingArena& arena);
+    static Item* build(const QJsonObject& description, SettingArena& arena);
+
+    static SettingDeclaration fromJson(const QJsonObject& description);
+    static SettingTypeId getTypeId(const QString& typeName);
+};
+
+} // namespace custom_setting
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QByteArray>
+#include <QIODevice>
+
+namespace custom_setting {
+
+class CompressedDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    explicit CompressedDevice(QIODevice* device, int level = 0, QObject* parent = nullptr);
+
+    bool open(OpenMode mode) override;
+    void close() override;
+    bool isSequential() const override;
+    qint64 bytesAvailable() const override;
+    bool isValid() const;
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+    qint64 writeData(const char* data, qint64 maxSize) override;
+
+private:
+    QIODevice* mDevice;
+    QByteArray mChunk;
+    int mOffset{0};
+    int mLevel;
+    bool mIsCompressing{false};
+    bool mIsFinished{false};
+    bool mIsValid{true};
+
+private:
+    bool readChunk();
+    bool writeChunk(int size);
+    void setInvalid();
+};
+
+class Compression
+{
+public:
+    static bool isCompressed(QIODevice* device);
+    static QByteArray read(QIODevice* device, qint64 maxSize = -1);
+};
+
+} // namespace custom_setting
@@ -148,6 +148,63 @@ DataList<T>::DataList(const QList<T>& lst, T val, T defaultValue) :
     list(lst)
 {}
 
+template <typename T>
+inline uint qHashDataValue(const T& value, uint seed)
+{
+    return qHash(value, seed);
+}
+
+inline uint qHashDataValue(const QFont& value, uint seed)
+{
+    return qHash(value.key(), seed);
+}
+
+inline uint qHashDataValue(const QColor& value, uint seed)
+{
+    return qHash(value.rgba(), seed);
+}
+
+inline uint qHashDataValue(const QMatrix& value, uint seed)
+{
+    return qHash(value.m11(), seed) ^ qHash(value.m22(), seed) ^ qHash(value.dx(), seed);
+}
+
+template <typename T>
+bool operator==(const Data<T>& lhs, const Data<T>& rhs)
+{
+    return lhs.value == rhs.value &&
+           lhs.defaultValue == rhs.defaultValue &&
+           lhs.resetValue == rhs.resetValue;
+}
+
+template <typename T>
+uint qHash(const Data<T>& data, uint seed = 0)
+{
+    return qHashDataValue(data.defaultValue, seed);
+}
+
+template <typename T>
+bool operator==(const DataDigit<T>& lhs, const DataDigit<T>& rhs)
+{
+    return static_cast<const Data<T>&>(lhs) == static_cast<const Data<T>&>(rhs) &&
+           lhs.minimum == rhs.minimum &&
+           lhs.maximum == rhs.maximum;
+}
+
+template <typename T>
+bool operator==(const DataList<T>& lhs, const DataList<T>& rhs)
+{
+    return static_cast<const Data<T>&>(lhs) == static_cast<const Data<T>&>(rhs) &&
+           lhs.list == rhs.list;
+}
+
+bool operator==(const DataCheckableStringList& lhs, const DataCheckableStringList& rhs);
+bool operator==(const DataChangeableStringList& lhs, const DataChangeableStringList& rhs);
+bool operator==(const DataInteger& lhs, const DataInteger& rhs);
+bool operator==(const DataDouble& lhs, const DataDouble& rhs);
+bool operator==(const DataSource& lhs, const DataSource& rhs);
+bool operator==(const DataStringMask& lhs, const DataStringMask& rhs);
+
 
 using DataByteArray             = Data<QByteArray>;
 using DataMatrix                = Data<QMatrix>;
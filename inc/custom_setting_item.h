@@ -32,9 +32,11 @@ public:
     void addItems(const List& items);
     void addSettingItems(const Map& items);
     void removeItem(Item* item);
+    void moveItem(Item* item, Item* destinationItem, int row);
 
     Item* getItem(int index);
     Setting* getSetting(int index);
+    Item* getParentItem() const;
     int getNumber() const;
 
     void clearItems();
@@ -42,14 +44,25 @@ public:
 protected:
     List mItems;
 
+protected:
+    void updateKeyPath() override;
+    void setManager(Manager* manager) override;
+
 private:
     ItemTreeModel* m_model{nullptr};
+    Item* mParentItem{nullptr};
+    int mRow{0};
 
 private:
     void addItemsPrivate(const List& items);
     void setItemsPrivate(const List& items);
     void removeItemPrivate(Item* item);
+    void moveItemPrivate(Item* item, Item* destinationItem, int row);
+    void takeItemPrivate(Item* item);
+    void insertItemPrivate(Item* item, int row);
     void clearPrivat();
+    void detachPrivate();
+    void updateRows(int first);
 
     friend ItemTreeModel;
 };
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <QAbstractItemModel>
+#include <QHash>
+#include <QPointer>
 #include "custom_setting_item.h"
 
 namespace custom_setting {
@@ -39,6 +41,9 @@ public:
     void addItems(Item* parentItem, const Item::List& items);
     void setItems(Item* parentItem, const Item::List& items);
     void removeItem(Item* parentItem, Item* item);
+    void moveItem(Item* parentItem, Item* item, Item* destinationItem, int row);
+    void takeItem(Item* parentItem, Item* item);
+    void insertItem(Item* parentItem, Item* item, int row);
     void clearItems(Item* parentItem);
     void setSettingValue(const QModelIndex& index, const QVariant& setting);
     void setFlags(Qt::ItemFlags aFlags);
@@ -53,14 +58,20 @@ private:
     Item* mRootItem{nullptr};
     QStringList mHeaders;
     Qt::ItemFlags mFlags;
+    QHash<Setting*, QPointer<Setting>> mChangedSettings;
     bool mIsItemEditing{false};
+    bool mIsFlushScheduled{false};
     DataChangeMode mDataChangeModel{DataChangeMode::eInternal};
 
 private:
     Item* getItem(const QModelIndex& index) const;
+    QModelIndex getIndex(Item* item) const;
     Setting* getSetting(const QModelIndex& index) const;
     Item* getRootItem() const;
     const QStringList& getHeaders();
+    void onSettingChanged(Setting* setting);
+    void scheduleFlush();
+    void flushChanges();
 };
 
 } // namespace custom_setting
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QMap>
+#include "custom_setting_serializer.h"
+
+namespace custom_setting {
+
+class SerializerJournal : public Serializer
+{
+    Q_OBJECT
+
+public:
+    SerializerJournal(Serializer* base, Mode mode, QObject* parent = nullptr);
+
+    using Serializer::setValue;
+    using Serializer::getValue;
+
+    void setValue(const KeyPath& path,
+                  const QVariant& value,
+                  bool asPlainValue) override;
+
+    QVariant getValue(const KeyPath& path,
+                      const QVariant& defaultValue,
+                      bool asPlainValue) override;
+
+    bool readValue(const KeyPath& path, ValueVisitor& visitor) override;
+    bool sync() override;
+    bool isPartialWriteSupported() const override;
+    void reset() override;
+
+    void setCompacting(bool isCompacting);
+    bool isCompacting() const;
+    qint64 getJournalSize() const;
+
+    static QString getJournalPath(const QString& filename);
+    static Serializer* create(const QString& filename,
+                              Mode mode,
+                              QObject* parent = nullptr);
+
+private:
+    Serializer* mBase;
+    QString mJournalPath;
+    QHash<QString, QVariant> mReplayed;
+    QMap<QString, QVariant> mPending;
+    qint64 mJournalEnd{-1};
+    mutable QByteArray mHeader;
+    mutable qint64 mBaseSize{-1};
+    mutable QDateTime mBaseModified;
+    bool mIsCompacting{false};
+
+private:
+    qint64 readRecords(const QByteArray& data, QHash<QString, QVariant>* values) const;
+    QByteArray createHeader() const;
+    bool append();
+    bool compact();
+};
+
+} // namespace custom_setting
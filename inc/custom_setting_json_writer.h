@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QIODevice>
+#include <QJsonDocument>
+#include <QJsonValue>
+#include "custom_setting_serializer.h"
+
+namespace custom_setting {
+
+class JsonStreamWriter
+{
+public:
+    JsonStreamWriter(QIODevice* device,
+                     QJsonDocument::JsonFormat format = QJsonDocument::Indented);
+
+    bool write(const ValueTree& tree);
+
+private:
+    QIODevice* mDevice;
+    bool mIsCompact;
+    bool mIsOk{true};
+
+private:
+    void writeNode(const ValueTree& tree, const ValueTree::Node& node, int indent);
+    void writeValue(const QJsonValue& value, int indent);
+    void writeString(const QString& string);
+    void writeIndent(int indent);
+    void writeSeparator(bool isLast);
+    void writeRaw(const QByteArray& data);
+};
+
+} // namespace custom_setting
@@ -2,28 +2,91 @@
 
 #include <QDir>
 #include <QApplication>
+#include <QFutureWatcher>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QSet>
+#include "custom_setting_serializer.h"
+#include "custom_setting_serializer_cache.h"
+#include "custom_setting_snapshot.h"
 
 namespace custom_setting
 {
 
 class Setting;
 
+template <typename T>
+T* settingCast(Setting* setting);
+
 class Manager : public QObject
 {
     Q_OBJECT
     using ConfigurationsMap = QMap<QString, Setting*>;
 
 public:
+    enum class SaveMode{kSync, kAsync};
+    enum class PersistenceMode{kSnapshot, kJournal};
+
+    class Transaction
+    {
+    public:
+        explicit Transaction(Manager* manager);
+        ~Transaction();
+
+    private:
+        Manager* mManager;
+
+        Q_DISABLE_COPY(Transaction)
+    };
+
     explicit Manager(QObject* parent = nullptr);
-    virtual ~Manager() = default;
+    virtual ~Manager();
 
     virtual void loadConfigurations();
     virtual void saveConfigurations();
     virtual void deleteConfiguration(const QString& filename);
 
+    QFuture<void> loadConfigurationsAsync();
+    void cancelLoading();
+    bool isLoading() const;
+
+    void setSaveMode(SaveMode mode);
+    void setSyncPolicy(Serializer::SyncPolicy policy);
+    bool isSaving() const;
+
+    void setPersistenceMode(PersistenceMode mode);
+    void setJournalCompactionSize(qint64 size);
+    void compactConfigurations();
+
+    void setCompressionLevel(const QString& filename, int level);
+
+    void beginTransaction();
+    void commitTransaction();
+    bool isInTransaction() const;
+
+    void setSnapshotEnabled(bool isEnabled);
+    SnapshotPublisher::Handle getSnapshot() const;
+
+    Setting* findSetting(const QString& path) const;
+
+    template <typename T>
+    T* find(const QString& path) const
+    {
+        return settingCast<T>(findSetting(path));
+    }
+
+    void setHotReloadEnabled(bool isEnabled);
+    void setHotReloadDelay(int msec);
+
 signals:
     void signalDataChanged();
     void signalDataLoaded();
+    void signalDataSaved(bool isOk);
+    void signalLoadProgress(int loaded, int total);
+    void signalLoadCanceled();
+    void signalConfigurationReloaded(const QString& filename);
+    void signalTransactionCommitted(const QStringList& keys);
+    void signalSnapshotPublished(quint64 version);
 
 protected:
     ConfigurationsMap mConfigurations;
@@ -31,6 +94,68 @@ protected:
 protected:
     virtual QString getSettingsDirPath() const;
     void setConfigurations(const ConfigurationsMap& configurations);
+    Serializer* createSerializer(const QString& filename, Serializer::Mode mode) const;
+
+private:
+    SaveMode mSaveMode{SaveMode::kSync};
+    Serializer::SyncPolicy mSyncPolicy{Serializer::SyncPolicy::kFile};
+    PersistenceMode mPersistenceMode{PersistenceMode::kSnapshot};
+    qint64 mJournalCompactionSize{256 * 1024};
+    QHash<QString, int> mCompressionLevels;
+    QHash<QString, Setting*> mSettingIndex;
+    QSet<Setting*> mManagedSettings;
+    int mTransactionDepth{0};
+    QVector<Setting*> mTransactionChanges;
+    QSet<Setting*> mChangedSettings;
+    bool mIsSnapshotEnabled{false};
+    bool mIsSnapshotRebuildNeeded{true};
+    QHash<QString, QVariant> mSnapshotValues;
+    QSet<Setting*> mSnapshotChanges;
+    SnapshotPublisher mSnapshotPublisher;
+    QTimer mSnapshotTimer;
+    QFutureWatcher<int> mLoadWatcher;
+    QStringList mLoadingFiles;
+    QVector<std::shared_ptr<Serializer>> mLoadedSerializers;
+    QVector<SerializerCache::Stamp> mLoadedStamps;
+    int mLoadedCount{0};
+    QFutureWatcher<QStringList> mSaveWatcher;
+    QMap<QString, std::shared_ptr<Serializer>> mSavingSerializers;
+    SerializerCache mSerializerCache;
+    QSet<QString> mUnsavedFiles;
+    bool mIsSavePending{false};
+    bool mIsHotReloadEnabled{false};
+    QFileSystemWatcher mFileWatcher;
+    QTimer mReloadTimer;
+    QSet<QString> mChangedFiles;
+    QHash<QString, QPair<QDateTime, qint64>> mSavedFileStates;
+
+private:
+    QVector<int> getUncachedReaders(const QStringList& filenames,
+                                    QVector<std::shared_ptr<Serializer>>& serializers,
+                                    QVector<SerializerCache::Stamp>& stamps) const;
+    void applyLoaded(const QString& filename,
+                     const std::shared_ptr<Serializer>& serializer,
+                     const SerializerCache::Stamp& stamp);
+    void onLoadResultReady(int index);
+    void onLoadFinished();
+    std::shared_ptr<Serializer> prepareSave(const QString& filename);
+    void saveConfigurationsAsync();
+    void onSaveFinished();
+    void onFileSaved(const QString& filename);
+    void updateWatchedFiles();
+    void onWatchedPathChanged();
+    void onFileChanged(const QString& path);
+    void reloadChangedFiles();
+    void registerSetting(Setting* setting);
+    void unregisterSetting(Setting* setting);
+    void addTransactionChange(Setting* setting);
+    void discardTransactionChange(Setting* setting);
+    void scheduleSnapshot();
+    void markSnapshotChanged(Setting* setting);
+    void updateSnapshotValue(Setting* setting);
+    void publishSnapshot();
+
+    friend Setting;
 };
 
 }  // namespace custom_setting
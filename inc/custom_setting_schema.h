@@ -0,0 +1,150 @@
+#pragma once
+
+#include <QAtomicInt>
+#include <QMultiHash>
+#include <QMutex>
+#include <QString>
+
+namespace custom_setting {
+
+class SettingSchema
+{
+public:
+    static QString internString(const QString& text);
+    static int getStringCount();
+};
+
+// Immutable value shared by every holder of an equal value. T needs an exact-type
+// operator== and qHash. Without isInterned, only copies of one handle share the value.
+template <typename T, bool isInterned = true>
+class SharedSchema
+{
+public:
+    SharedSchema() :
+        SharedSchema(T{})
+    {}
+
+    explicit SharedSchema(const T& value) :
+        mEntry(acquire(value))
+    {}
+
+    SharedSchema(const SharedSchema& schema) :
+        mEntry(schema.mEntry)
+    {
+        mEntry->refs.ref();
+    }
+
+    SharedSchema& operator=(const SharedSchema& schema)
+    {
+        if (mEntry != schema.mEntry)
+        {
+            schema.mEntry->refs.ref();
+            release(mEntry);
+            mEntry = schema.mEntry;
+        }
+
+        return *this;
+    }
+
+    ~SharedSchema()
+    {
+        release(mEntry);
+    }
+
+    const T& operator*() const { return mEntry->value; }
+    const T* operator->() const { return &mEntry->value; }
+
+    static int getCount()
+    {
+        auto& pool = getPool();
+        QMutexLocker locker(&pool.mutex);
+
+        return pool.entries.size();
+    }
+
+private:
+    struct Entry
+    {
+        T value;
+        uint hash;
+        QAtomicInt refs;
+    };
+
+    struct Pool
+    {
+        QMutex mutex;
+        QMultiHash<uint, Entry*> entries;
+    };
+
+    Entry* mEntry;
+
+    // Leaked on purpose: settings may outlive static destruction.
+    static Pool& getPool()
+    {
+        static auto pool = new Pool;
+        return *pool;
+    }
+
+    static Entry* acquire(const T& value)
+    {
+        if constexpr (!isInterned)
+        {
+            return new Entry{value, 0, 1};
+        }
+        else
+        {
+            const auto hash = qHash(value);
+            auto& pool = getPool();
+            QMutexLocker locker(&pool.mutex);
+
+            for (auto it = pool.entries.constFind(hash);
+                 it != pool.entries.constEnd() && it.key() == hash;
+                 ++it)
+            {
+                if ((*it)->value == value)
+                {
+                    (*it)->refs.ref();
+                    return *it;
+                }
+            }
+
+            auto entry = new Entry{value, hash, 1};
+            pool.entries.insert(hash, entry);
+
+            return entry;
+        }
+    }
+
+    // Only the last reference takes the lock, so it can't race with acquire().
+    static void release(Entry* entry)
+    {
+        if constexpr (!isInterned)
+        {
+            if (!entry->refs.deref())
+            {
+                delete entry;
+            }
+
+            return;
+        }
+
+        for (int refs = entry->refs.loadAcquire(); refs > 1; refs = entry->refs.loadAcquire())
+        {
+            if (entry->refs.testAndSetOrdered(refs, refs - 1))
+            {
+                return;
+            }
+        }
+
+        auto& pool = getPool();
+        QMutexLocker locker(&pool.mutex);
+
+        if (!entry->refs.deref())
+        {
+            pool.entries.remove(entry->hash, entry);
+            delete entry;
+        }
+    }
+};
+
+} // namespace custom_setting
@@ -5,11 +5,74 @@
 #include <QObject>
 #include <QSettings>
 #include <QJsonObject>
+#include <QJsonDocument>
+#include <QFile>
+#include <QMap>
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+#include <QCborStreamReader>
+#include <QCborStreamWriter>
+#include <functional>
+#include <memory>
+
+class QSqlQuery;
 
 namespace custom_setting {
 
 class SerializerIni;
 class SerializerJson;
+class SerializerBinary;
+class SerializerCbor;
+class SerializerSqlite;
+
+struct KeyPath
+{
+    QString key;
+    QStringList segments;
+
+    static KeyPath fromKey(const QString& key);
+};
+
+class ValueVisitor
+{
+public:
+    virtual ~ValueVisitor() = default;
+
+    virtual void visit(bool value) = 0;
+    virtual void visit(qint64 value) = 0;
+    virtual void visit(double value) = 0;
+    virtual void visit(QString&& value) = 0;
+    virtual void visit(QStringList&& value) = 0;
+    virtual void visit(QByteArray&& value) = 0;
+    virtual void visit(QVariant&& value) = 0;
+};
+
+class ValueTree
+{
+public:
+    struct Node
+    {
+        QString key;
+        QVariant value;
+        QMap<QString, int> children;
+    };
+
+    // Member that holds the value of a node which also has children.
+    static constexpr char kValueKey[] = "@value";
+
+    ValueTree();
+
+    void setValue(const KeyPath& path, const QVariant& value);
+    const Node& getNode(int index) const;
+    const Node& getRoot() const;
+    bool isEmpty() const;
+    void clear();
+
+private:
+    QVector<Node> mNodes;
+    QHash<QString, int> mPathIndex;
+};
 
 class Serializer : public QObject
 {
@@ -17,26 +80,56 @@ class Serializer : public QObject
 
 public:
     enum class Mode{kRead, kWrite};
+    enum class SyncPolicy{kNone, kFile, kFileAndDirectory};
+
+    using Factory = std::function<Serializer*(const QString& filename,
+                                              Mode mode,
+                                              QObject* parent)>;
+    using Sniffer = std::function<bool(const QByteArray& header)>;
 
     Serializer(const QString& filename, Mode mode, QObject* parent = nullptr);
     virtual ~Serializer() = default;
 
-    virtual void setValue(const QString& key,
+    virtual void setValue(const KeyPath& path,
                           const QVariant& value,
                           bool asPlainValue = true) = 0;
 
-    virtual QVariant getValue(const QString& key,
+    virtual QVariant getValue(const KeyPath& path,
                               const QVariant& default_value,
                               bool asPlainValue) = 0;
-    virtual void sync() = 0;
+
+    void setValue(const QString& key,
+                  const QVariant& value,
+                  bool asPlainValue = true);
+
+    QVariant getValue(const QString& key,
+                      const QVariant& default_value,
+                      bool asPlainValue);
+
+    virtual bool readValue(const KeyPath& path, ValueVisitor& visitor);
+    virtual bool sync() = 0;
+    virtual bool isPartialWriteSupported() const;
+    virtual void reset();
+    virtual void releaseFile();
+
+    void setSyncPolicy(SyncPolicy policy);
+    void setCompressionLevel(int level);
+    int getCompressionLevel() const;
+    const QString& getFilename() const;
 
     static Serializer* create(const QString& filename,
                               Mode mode,
                               QObject* parent = nullptr);
 
+    static void registerFormat(const QString& suffix,
+                               const Factory& factory,
+                               const Sniffer& sniffer = {});
+
 protected:
     QString mFilename;
     Mode mMode;
+    SyncPolicy mSyncPolicy{SyncPolicy::kFile};
+    int mCompressionLevel{0};
 };
 
 class SerializerIni : public Serializer
@@ -46,18 +139,24 @@ class SerializerIni : public Serializer
 public:
     SerializerIni(const QString& filename, Mode mode, QObject* parent = nullptr);
 
-    void setValue(const QString& key,
+    using Serializer::setValue;
+    using Serializer::getValue;
+
+    void setValue(const KeyPath& path,
                   const QVariant& value,
                   bool asPlainValue) override;
 
-    QVariant getValue(const QString &key,
+    QVariant getValue(const KeyPath& path,
                       const QVariant& defaultValue,
                       bool asPlainValue) override;
 
-    void sync() override;
+    bool sync() override;
+    bool isPartialWriteSupported() const override;
+    void reset() override;
 
 private:
-    QSettings* mSettings;
+    QSettings* mSettings{nullptr};
+    QMap<QString, QVariant> mValues;
 };
 
 class SerializerJson : public Serializer
@@ -67,22 +166,125 @@ class SerializerJson : public Serializer
 public:
     SerializerJson(const QString& filename, Mode mode, QObject* parent = nullptr);
 
-    void setValue(const QString& key,
+    using Serializer::setValue;
+    using Serializer::getValue;
+
+    void setValue(const KeyPath& path,
                   const QVariant& value,
                   bool asPlainValue) override;
 
-    QVariant getValue(const QString& key,
+    QVariant getValue(const KeyPath& path,
                       const QVariant& defaultValue,
                       bool asPlainValue) override;
 
-    void sync() override;
+    bool readValue(const KeyPath& path, ValueVisitor& visitor) override;
+    bool sync() override;
+    void reset() override;
+
+    void setFormat(QJsonDocument::JsonFormat format);
 
 private:
-    QJsonObject mJsonObject;
+    ValueTree mTree;
+    QHash<QString, QJsonValue> mIndex;
+    QJsonDocument::JsonFormat mFormat{QJsonDocument::Indented};
 
-    void write(QJsonObject& obj, const QString& key, const QVariant& value);
-    QVariant read(QJsonObject obj, const QString& key, const QVariant& defaultValue);
+    void buildIndex(const QJsonObject& obj, const QString& prefix);
 };
 
-} // namespace custom_setting
+class SerializerBinary : public Serializer
+{
+    Q_OBJECT
+
+public:
+    SerializerBinary(const QString& filename, Mode mode, QObject* parent = nullptr);
+
+    using Serializer::setValue;
+    using Serializer::getValue;
+
+    void setValue(const KeyPath& path,
+                  const QVariant& value,
+                  bool asPlainValue) override;
 
+    QVariant getValue(const KeyPath& path,
+                      const QVariant& defaultValue,
+                      bool asPlainValue) override;
+
+    bool sync() override;
+    void reset() override;
+    void releaseFile() override;
+
+private:
+    QFile mFile;
+    QByteArray mBuffer;
+    const uchar* mData{nullptr};
+    qint64 mSize{0};
+    quint32 mCount{0};
+    QMap<QString, QVariant> mValues;
+
+    const uchar* findEntry(const QString& key) const;
+    bool isKeyEqual(const uchar* entry, const QString& key) const;
+};
+
+class SerializerCbor : public Serializer
+{
+    Q_OBJECT
+
+public:
+    SerializerCbor(const QString& filename, Mode mode, QObject* parent = nullptr);
+
+    using Serializer::setValue;
+    using Serializer::getValue;
+
+    void setValue(const KeyPath& path,
+                  const QVariant& value,
+                  bool asPlainValue) override;
+
+    QVariant getValue(const KeyPath& path,
+                      const QVariant& defaultValue,
+                      bool asPlainValue) override;
+
+    bool sync() override;
+    void reset() override;
+
+private:
+    ValueTree mTree;
+    QHash<QString, QVariant> mIndex;
+
+    bool readMap(QCborStreamReader& reader, const QString& prefix);
+    void writeNode(QCborStreamWriter& writer, const ValueTree::Node& node) const;
+};
+
+class SerializerSqlite : public Serializer
+{
+    Q_OBJECT
+
+public:
+    SerializerSqlite(const QString& filename, Mode mode, QObject* parent = nullptr);
+    ~SerializerSqlite() override;
+
+    using Serializer::setValue;
+    using Serializer::getValue;
+
+    void setValue(const KeyPath& path,
+                  const QVariant& value,
+                  bool asPlainValue) override;
+
+    QVariant getValue(const KeyPath& path,
+                      const QVariant& defaultValue,
+                      bool asPlainValue) override;
+
+    bool sync() override;
+    bool isPartialWriteSupported() const override;
+    void reset() override;
+
+private:
+    QString mConnectionName;
+    std::unique_ptr<QSqlQuery> mSelectQuery;
+    QMap<QString, QVariant> mValues;
+    bool mIsReadFailed{false};
+
+    bool prepareSelect();
+    bool writeValues(const QString& connectionName);
+};
+
+} // namespace custom_setting
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <memory>
+#include "custom_setting_serializer.h"
+
+namespace custom_setting {
+
+class SerializerCache
+{
+public:
+    struct Stamp
+    {
+        QDateTime lastModified;
+        qint64 size{-1};
+    };
+
+    std::shared_ptr<Serializer> getReader(const QString& filename) const;
+    void setReader(const QString& filename,
+                   const std::shared_ptr<Serializer>& serializer,
+                   const Stamp& stamp);
+
+    std::shared_ptr<Serializer> getWriter(const QString& filename);
+    void setWriterFactory(const Serializer::Factory& factory);
+
+    void invalidate(const QString& filename);
+    void remove(const QString& filename);
+    void clear();
+
+    static Stamp getStamp(const QString& filename);
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<Serializer> reader;
+        std::shared_ptr<Serializer> writer;
+        Stamp stamp;
+    };
+
+    QHash<QString, Entry> mEntries;
+    Serializer::Factory mWriterFactory{&Serializer::create};
+};
+
+} // namespace custom_setting
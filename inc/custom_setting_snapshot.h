@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QVariant>
+#include <atomic>
+#include <memory>
+
+namespace custom_setting {
+
+class Snapshot
+{
+public:
+    Snapshot(quint64 version, QHash<QString, QVariant>&& values);
+
+    quint64 getVersion() const;
+    QVariant getValue(const QString& path, const QVariant& defaultValue = {}) const;
+    const QHash<QString, QVariant>& getValues() const;
+
+private:
+    quint64 mVersion;
+    QHash<QString, QVariant> mValues;
+};
+
+class SnapshotPublisher
+{
+public:
+    class Handle
+    {
+    public:
+        Handle() = default;
+        Handle(Handle&& handle);
+        Handle& operator=(Handle&& handle);
+        ~Handle();
+
+        const Snapshot* operator->() const;
+        const Snapshot& operator*() const;
+        bool isValid() const;
+
+    private:
+        Handle(std::atomic<int>* readers, const Snapshot* snapshot);
+        void release();
+
+        std::atomic<int>* mReaders{nullptr};
+        const Snapshot* mSnapshot{nullptr};
+
+        friend SnapshotPublisher;
+    };
+
+    SnapshotPublisher() = default;
+
+    Handle acquire() const;
+    bool publish(QHash<QString, QVariant>&& values);
+    quint64 getVersion() const;
+
+private:
+    struct Slot
+    {
+        std::atomic<int> readers{0};
+        std::unique_ptr<Snapshot> snapshot;
+    };
+
+    static const int kSlotCount = 8;
+
+    mutable Slot mSlots[kSlotCount];
+    std::atomic<int> mCurrent{-1};
+    quint64 mVersion{0};
+
+    Q_DISABLE_COPY(SnapshotPublisher)
+};
+
+} // namespace custom_setting
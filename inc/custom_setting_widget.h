@@ -2,6 +2,7 @@
 
 #include <QWidget>
 #include <QVBoxLayout>
+#include <array>
 #include "custom_setting.h"
 #include "custom_widgets.h"
 
@@ -39,14 +40,35 @@ private:
     int mItemWidth{-1};
     int mItemsRowsCount{1};
 
+private:
+    using SettingMethod = bool (CustomSettingWidget::*)(custom_setting::Setting*);
+    using SettingMethods = std::array<SettingMethod, int(custom_setting::SettingTypeId::kCount)>;
+
+    struct SettingMethodTable
+    {
+        SettingMethods bindMethods;
+        SettingMethods setMethods;
+    };
+
 private:
     void clear();
     void applySizeHint();
 
+    static const SettingMethodTable& getMethodTable();
+
+    template <typename SettingType, typename WidgetType>
+    static void addMethods(SettingMethodTable& table)
+    {
+        table.bindMethods[int(SettingType::kTypeId)] =
+            &CustomSettingWidget::bindSetting_if<SettingType, WidgetType>;
+        table.setMethods[int(SettingType::kTypeId)] =
+            &CustomSettingWidget::setSetting_if<SettingType, WidgetType>;
+    }
+
     template <typename SettingType, typename WidgetType>
     bool bindSetting_if(custom_setting::Setting* setting)
     {
-        if (auto customSetting = dynamic_cast<SettingType*>(setting))
+        if (auto customSetting = custom_setting::settingCast<SettingType>(setting))
         {
             auto customWidget = new WidgetType();
             mWidget = customWidget;
@@ -65,7 +87,7 @@ private:
     template<typename SettingType, typename WidgetType>
     bool setSetting_if(custom_setting::Setting* setting)
     {
-        if (auto customSetting = dynamic_cast<SettingType*>(setting))
+        if (auto customSetting = custom_setting::settingCast<SettingType>(setting))
         {
             auto tmpSetting = new SettingType(*customSetting, this);
             mSetting = tmpSetting;
@@ -1,4 +1,5 @@
 #include "custom_setting.h"
+#include "custom_setting_arena.h"
 #include "custom_setting_serializer.h"
 
 using namespace custom_setting;
@@ -10,10 +11,41 @@ Setting::Setting(const QString& key,
                  QObject* parent) :
     QObject(parent),
     mKey(key),
-    mCaption(caption),
-    mDescription(description),
+    mCaption(SettingSchema::internString(caption)),
+    mDescription(SettingSchema::internString(description)),
     mReadOnly(readOnly)
-{}
+{
+    updateKeyPath();
+}
+
+Setting::~Setting()
+{
+    if (mManager)
+    {
+        mManager->unregisterSetting(this);
+        mManager->discardTransactionChange(this);
+    }
+}
+
+void* Setting::operator new(std::size_t size)
+{
+    return SettingArena::allocate(size, nullptr);
+}
+
+void Setting::operator delete(void* memory)
+{
+    SettingArena::deallocate(memory);
+}
+
+void* Setting::operator new(std::size_t size, SettingArena& arena)
+{
+    return SettingArena::allocate(size, &arena);
+}
+
+void Setting::operator delete(void* memory, SettingArena&)
+{
+    SettingArena::deallocate(memory);
+}
 
 void Setting::addSettings(const Vector& settings)
 {
@@ -21,42 +53,219 @@ void Setting::addSettings(const Vector& settings)
 
     for (auto& setting : settings)
     {
-        setting->setParent(this);
+        setting->setParentSetting(this);
+        setting->setManager(mManager);
+    }
+}
 
-        connect(setting, &Setting::signalDataChanged,
-                this, &Setting::signalDataChanged);
+void Setting::setParentSetting(Setting* parent)
+{
+    mParentSetting = parent;
+    setParent(parent);
+    updateKeyPath();
+}
+
+void Setting::updateKeyPath()
+{
+    if (mManager)
+    {
+        mManager->unregisterSetting(this);
+    }
+
+    if (mParentSetting && !mIsKeyRoot)
+    {
+        mKeyPath.key = mParentSetting->mKeyPath.key + '/' + mKey;
+        mKeyPath.segments = mParentSetting->mKeyPath.segments;
+        mKeyPath.segments.append(mKey);
+    }
+    else
+    {
+        mKeyPath.key = '/' + mKey;
+        mKeyPath.segments = QStringList{mKey};
+    }
+
+    if (mManager)
+    {
+        mManager->registerSetting(this);
+    }
+
+    for (auto& setting : mSettings)
+    {
+        setting->updateKeyPath();
     }
 }
 
-void Setting::load(Serializer* serializer, const QString& parentKey)
+void Setting::setManager(Manager* manager)
 {
-    const auto& key = parentKey + "/" + mKey;
-    auto value = serializer->getValue(key, getDefaultValue(), !mSettings.isEmpty());
+    if (mManager)
+    {
+        mManager->unregisterSetting(this);
+    }
 
-    if (value.isValid())
+    mManager = manager;
+
+    if (mManager)
     {
-        setValue(value);
+        mManager->registerSetting(this);
     }
 
+    for (auto& setting : mSettings)
+    {
+        setting->setManager(manager);
+    }
+}
+
+void Setting::setKeyRoot(bool isKeyRoot)
+{
+    mIsKeyRoot = isKeyRoot;
+    updateKeyPath();
+}
+
+const QString& Setting::getKey() const
+{
+    return mKey;
+}
+
+const KeyPath& Setting::getKeyPath() const
+{
+    return mKeyPath;
+}
+
+void Setting::load(const std::shared_ptr<Serializer>& serializer)
+{
+    if (mIsLazyLoad)
+    {
+        deferLoad(serializer);
+        return;
+    }
+
+    cancelPendingLoad();
+    readValue(*serializer, false);
+
     for (auto& customSetting : mSettings)
     {
-        customSetting->load(serializer, key);
+        customSetting->load(serializer);
     }
 }
 
-void Setting::save(Serializer* serializer, const QString& parentKey)
+void Setting::reload(const std::shared_ptr<Serializer>& serializer)
 {
-    const auto& key = parentKey + "/" + mKey;
-    const auto& value = getValue();
+    if (mPendingSerializer)
+    {
+        mPendingSerializer = serializer;
+    }
+    else if (!mIsValueDirty)
+    {
+        const auto& currentValue = getValue();
+
+        if (currentValue.isValid())
+        {
+            auto value = serializer->getValue(mKeyPath, currentValue, !mSettings.isEmpty());
+
+            // Reloaded values match the file, so they must not mark the tree dirty.
+            if (value.isValid() && value != currentValue)
+            {
+                loadValue(value);
+                emitSignalDataChanged(getValue());
+            }
+        }
+    }
 
-    if (value.isValid())
+    for (auto& customSetting : mSettings)
     {
-        serializer->setValue(key, value, !mSettings.isEmpty());
+        customSetting->reload(serializer);
     }
+}
+
+void Setting::deferLoad(const std::shared_ptr<Serializer>& serializer)
+{
+    mPendingSerializer = serializer;
 
     for (auto& customSetting : mSettings)
     {
-        customSetting->save(serializer, key);
+        customSetting->deferLoad(serializer);
+    }
+}
+
+void Setting::loadPending()
+{
+    auto serializer = std::move(mPendingSerializer);
+    mPendingSerializer.reset();
+
+    readValue(*serializer, true);
+
+    if (mManager)
+    {
+        mManager->markSnapshotChanged(this);
+    }
+}
+
+void Setting::ensureLoaded() const
+{
+    if (mPendingSerializer)
+    {
+        const_cast<Setting*>(this)->loadPending();
+    }
+}
+
+void Setting::cancelPendingLoad()
+{
+    mPendingSerializer.reset();
+}
+
+void Setting::loadValue(const QVariant&)
+{
+}
+
+void Setting::readValue(Serializer& serializer, bool isSilent)
+{
+    auto value = serializer.getValue(mKeyPath, getDefaultValue(), !mSettings.isEmpty());
+
+    if (!value.isValid())
+    {
+        return;
+    }
+
+    if (isSilent)
+    {
+        loadValue(value);
+    }
+    else
+    {
+        setValue(value);
+    }
+}
+
+void Setting::setLazyLoad(bool isLazyLoad)
+{
+    mIsLazyLoad = isLazyLoad;
+}
+
+bool Setting::isLazyLoad() const
+{
+    return mIsLazyLoad;
+}
+
+void Setting::save(Serializer* serializer, bool isDirtyOnly)
+{
+    if (isDirtyOnly && !mIsTreeDirty)
+    {
+        return;
+    }
+
+    if (!isDirtyOnly || mIsValueDirty)
+    {
+        const auto& value = getValue();
+
+        if (value.isValid())
+        {
+            serializer->setValue(mKeyPath, value, !mSettings.isEmpty());
+        }
+    }
+
+    for (auto& customSetting : mSettings)
+    {
+        customSetting->save(serializer, isDirtyOnly);
     }
 }
 
@@ -105,16 +314,66 @@ const Setting::Vector& Setting::getSettings() const
     return mSettings;
 }
 
+Setting* Setting::getParentSetting() const
+{
+    return mParentSetting;
+}
+
+Manager* Setting::getManager() const
+{
+    return mManager;
+}
+
+SettingTypeId Setting::getTypeId() const
+{
+    return mTypeId;
+}
+
 bool Setting::isReadOnly() const
 {
     return mReadOnly;
 }
 
+bool Setting::isDirty() const
+{
+    return mIsTreeDirty;
+}
+
+void Setting::markDirty()
+{
+    mIsValueDirty = true;
+
+    for (auto setting = this; setting && !setting->mIsTreeDirty;
+         setting = setting->mParentSetting)
+    {
+        setting->mIsTreeDirty = true;
+    }
+}
+
+void Setting::clearDirty()
+{
+    if (!mIsTreeDirty)
+    {
+        return;
+    }
+
+    mIsValueDirty = false;
+    mIsTreeDirty = false;
+
+    for (auto child : children())
+    {
+        if (auto setting = qobject_cast<Setting*>(child))
+        {
+            setting->clearDirty();
+        }
+    }
+}
+
 bool Setting::isAnyChecked() const
 {
     for (auto& setting : getSettings())
     {
-        if (auto boolSetting = dynamic_cast<SettingBool*>(setting))
+        if (auto boolSetting = settingCast<SettingBool>(setting))
         {
             if (*boolSetting)
             {
@@ -138,12 +397,12 @@ QVariant Setting::getDefaultValue() const
 
 void Setting::setCaption(const QString& caption)
 {
-    mCaption = caption;
+    mCaption = SettingSchema::internString(caption);
 }
 
 void Setting::setDescription(const QString& description)
 {
-    mDescription = description;
+    mDescription = SettingSchema::internString(description);
 }
 
 void Setting::setValue(const QVariant&)
@@ -156,5 +415,20 @@ void Setting::notifyValue(const QVariant&)
 
 void Setting::emitSignalDataChanged(const QVariant& value)
 {
-    emit signalDataChanged(value);
+    if (mManager && mManager->isInTransaction())
+    {
+        mManager->addTransactionChange(this);
+        return;
+    }
+
+    if (mManager)
+    {
+        mManager->markSnapshotChanged(this);
+    }
+
+    for (auto setting = this; setting; setting = setting->mParentSetting)
+    {
+        emit setting->signalDataChanged(value);
+        emit setting->signalSettingChanged(this);
+    }
 }
@@ -0,0 +1,130 @@
+#include "custom_setting_arena.h"
+#include <cstdint>
+
+using namespace custom_setting;
+
+namespace
+{
+
+struct AllocationHeader
+{
+    SettingArena* arena;
+    Setting* setting;
+    std::size_t size;
+};
+
+const std::size_t kAlignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+const std::size_t kBlockSize = 64 * 1024;
+
+// Padded so that the setting after the header lands on the arena tag offset.
+const std::size_t kHeaderSize =
+    (sizeof(AllocationHeader) + kAlignment / 2 - 1) / kAlignment * kAlignment + kAlignment / 2;
+
+std::size_t alignSize(std::size_t size)
+{
+    return (size + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+AllocationHeader* getHeader(void* memory)
+{
+    return reinterpret_cast<AllocationHeader*>(static_cast<char*>(memory) - kHeaderSize);
+}
+
+} // namespace
+
+SettingArena::~SettingArena()
+{
+    clear();
+}
+
+void SettingArena::clear()
+{
+    // Blocks are walked in allocation order, so roots come first and most settings
+    // go away with their parent's children.
+    for (auto& block : mBlocks)
+    {
+        for (std::size_t offset = 0; offset < block.used;)
+        {
+            auto header = reinterpret_cast<AllocationHeader*>(block.memory.get() + offset);
+            offset += header->size;
+
+            if (header->setting)
+            {
+                delete header->setting;
+            }
+        }
+    }
+
+    mBlocks.clear();
+    mBlockIndex = 0;
+    mCapacity = 0;
+    mSize = 0;
+}
+
+int SettingArena::getSize() const
+{
+    return mSize;
+}
+
+std::size_t SettingArena::getCapacity() const
+{
+    return mCapacity;
+}
+
+void* SettingArena::allocate(std::size_t size, SettingArena* arena)
+{
+    if (!arena)
+    {
+        return ::operator new(size);
+    }
+
+    size = alignSize(size + kHeaderSize);
+
+    auto memory = static_cast<char*>(arena->allocateBlock(size));
+    new (memory) AllocationHeader{arena, nullptr, size};
+    ++arena->mSize;
+
+    return memory + kHeaderSize;
+}
+
+void SettingArena::deallocate(void* memory)
+{
+    if (!(reinterpret_cast<std::uintptr_t>(memory) & kArenaTag))
+    {
+        ::operator delete(memory);
+        return;
+    }
+
+    auto header = getHeader(memory);
+    header->setting = nullptr;
+    --header->arena->mSize;
+}
+
+void SettingArena::attach(void* memory, Setting* setting)
+{
+    getHeader(memory)->setting = setting;
+}
+
+void* SettingArena::allocateBlock(std::size_t size)
+{
+    if (size > kBlockSize / 4)
+    {
+        mBlocks.push_back({std::unique_ptr<char[]>(new char[size]), size});
+        mCapacity += size;
+
+        return mBlocks.back().memory.get();
+    }
+
+    if (mBlocks.empty() || mBlocks[mBlockIndex].used + size > kBlockSize)
+    {
+        mBlocks.push_back({std::unique_ptr<char[]>(new char[kBlockSize]), 0});
+        mBlockIndex = mBlocks.size() - 1;
+        mCapacity += kBlockSize;
+    }
+
+    auto& block = mBlocks[mBlockIndex];
+    auto memory = block.memory.get() + block.used;
+    block.used += size;
+
+    return memory;
+}
@@ -0,0 +1,148 @@
+#include "custom_setting_atomic_file.h"
+#include <QFileInfo>
+#include <QDir>
+
+#ifdef Q_OS_WIN
+#include <qt_windows.h>
+#include <io.h>
+#else
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace custom_setting;
+
+AtomicFile::AtomicFile(const QString& filename, Serializer::SyncPolicy policy)
+    : mFilename(filename)
+    , mFile(filename + ".tmp")
+    , mPolicy(policy)
+{}
+
+AtomicFile::~AtomicFile()
+{
+    if (!mIsCommitted)
+    {
+        mFile.close();
+        mFile.remove();
+    }
+}
+
+void AtomicFile::setCompressionLevel(int level)
+{
+    mCompressionLevel = level;
+}
+
+bool AtomicFile::open()
+{
+    if (!mFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    if (mCompressionLevel != 0)
+    {
+        mCompressedDevice.reset(new CompressedDevice(&mFile, mCompressionLevel));
+        return mCompressedDevice->open(QIODevice::WriteOnly);
+    }
+
+    return true;
+}
+
+QIODevice* AtomicFile::getDevice()
+{
+    if (mCompressedDevice)
+    {
+        return mCompressedDevice.get();
+    }
+
+    return &mFile;
+}
+
+bool AtomicFile::commit()
+{
+    if (!mFile.isOpen())
+    {
+        return false;
+    }
+
+    if (mCompressedDevice)
+    {
+        mCompressedDevice->close();
+
+        if (!mCompressedDevice->isValid())
+        {
+            return false;
+        }
+    }
+
+    if (!mFile.flush() || mFile.error() != QFile::NoError)
+    {
+        return false;
+    }
+
+    if (mPolicy != Serializer::SyncPolicy::kNone && !syncFile())
+    {
+        return false;
+    }
+
+    mFile.close();
+
+    if (!replaceTarget())
+    {
+        return false;
+    }
+
+    mIsCommitted = true;
+
+    if (mPolicy == Serializer::SyncPolicy::kFileAndDirectory)
+    {
+        return syncDirectory();
+    }
+
+    return true;
+}
+
+bool AtomicFile::syncFile()
+{
+#ifdef Q_OS_WIN
+    return _commit(mFile.handle()) == 0;
+#else
+    return ::fsync(mFile.handle()) == 0;
+#endif
+}
+
+bool AtomicFile::syncDirectory() const
+{
+#ifdef Q_OS_WIN
+    return true;
+#else
+    auto path = QFile::encodeName(QFileInfo(mFilename).absolutePath());
+    int fd = ::open(path.constData(), O_RDONLY);
+
+    if (fd == -1)
+    {
+        return false;
+    }
+
+    bool isOk = ::fsync(fd) == 0;
+    ::close(fd);
+
+    return isOk;
+#endif
+}
+
+bool AtomicFile::replaceTarget()
+{
+#ifdef Q_OS_WIN
+    auto source = QDir::toNativeSeparators(mFile.fileName());
+    auto target = QDir::toNativeSeparators(mFilename);
+
+    return MoveFileExW(reinterpret_cast<const wchar_t*>(source.utf16()),
+                       reinterpret_cast<const wchar_t*>(target.utf16()),
+                       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    return ::rename(QFile::encodeName(mFile.fileName()).constData(),
+                    QFile::encodeName(mFilename).constData()) == 0;
+#endif
+}
@@ -0,0 +1,283 @@
+#include "custom_setting_builder.h"
+#include "custom_setting_arena.h"
+#include "custom_setting_item.h"
+#include <QHash>
+#include <QJsonArray>
+#include <array>
+
+using namespace custom_setting;
+
+namespace
+{
+
+using CreateMethod = Setting* (*)(const SettingDeclaration&, SettingArena&);
+using CreateMethodTable = std::array<CreateMethod, size_t(SettingTypeId::kCount)>;
+
+template <typename T>
+void applyList(T&, const QVariant&)
+{
+}
+
+template <typename T>
+void applyList(DataList<T>& data, const QVariant& list)
+{
+    for (const auto& value : list.toList())
+    {
+        data.list.append(value.value<T>());
+    }
+}
+
+void applyList(DataCheckableStringList& data, const QVariant& list)
+{
+    data.list = list.toStringList();
+}
+
+template <typename T>
+void applyLimits(DataDigit<T>& data, const SettingDeclaration& declaration)
+{
+    if (declaration.minimum.isValid())
+    {
+        data.minimum = declaration.minimum.value<T>();
+    }
+
+    if (declaration.maximum.isValid())
+    {
+        data.maximum = declaration.maximum.value<T>();
+    }
+}
+
+template <typename T>
+void applyOptions(T&, const SettingDeclaration&)
+{
+}
+
+void applyOptions(DataInteger& data, const SettingDeclaration& declaration)
+{
+    applyLimits(data, declaration);
+    data.suffix = declaration.suffix;
+}
+
+void applyOptions(DataDouble& data, const SettingDeclaration& declaration)
+{
+    applyLimits(data, declaration);
+    data.suffix = declaration.suffix;
+
+    if (declaration.decimals.isValid())
+    {
+        data.decimals = declaration.decimals.toInt();
+    }
+}
+
+void applyOptions(DataStringMask& data, const SettingDeclaration& declaration)
+{
+    data.regexValidatorString = declaration.validator;
+}
+
+void applyOptions(DataSource& data, const SettingDeclaration& declaration)
+{
+    data.sourceType = declaration.sourceType;
+    data.filters = declaration.filters;
+}
+
+void applyOptions(DataChangeableStringList& data, const SettingDeclaration& declaration)
+{
+    data.listType = declaration.listType;
+    data.isUniqItems = declaration.isUniqItems;
+    data.filters = declaration.filters;
+}
+
+template <typename T>
+Setting* createSetting(const SettingDeclaration& declaration, SettingArena& arena)
+{
+    using ValueType = typename T::ValueType;
+
+    T data;
+
+    if (declaration.defaultValue.isValid())
+    {
+        data.defaultValue = declaration.defaultValue.value<ValueType>();
+    }
+
+    if (declaration.value.isValid())
+    {
+        data.value = declaration.value.value<ValueType>();
+        data.resetValue = data.value;
+    }
+
+    applyList(data, declaration.list);
+    applyOptions(data, declaration);
+
+    return arena.create<SettingExt<T>>(declaration.key,
+                                       declaration.caption,
+                                       declaration.description,
+                                       data,
+                                       declaration.readOnly);
+}
+
+template <typename T>
+void addCreateMethod(CreateMethodTable& methods)
+{
+    methods[size_t(SettingExt<T>::kTypeId)] = &createSetting<T>;
+}
+
+const CreateMethodTable& getCreateMethods()
+{
+    static const CreateMethodTable table = [] {
+        CreateMethodTable methods{};
+        addCreateMethod<DataInteger>(methods);
+        addCreateMethod<DataUnsigned>(methods);
+        addCreateMethod<DataDouble>(methods);
+        addCreateMethod<DataBool>(methods);
+        addCreateMethod<DataStringMask>(methods);
+        addCreateMethod<DataStringList>(methods);
+        addCreateMethod<DataCheckList>(methods);
+        addCreateMethod<DataByteArray>(methods);
+        addCreateMethod<DataFont>(methods);
+        addCreateMethod<DataColor>(methods);
+        addCreateMethod<DataSource>(methods);
+        addCreateMethod<DataDateTime>(methods);
+        addCreateMethod<DataEditableStringList>(methods);
+        addCreateMethod<DataCheckableStringList>(methods);
+        addCreateMethod<DataChangeableStringList>(methods);
+        return methods;
+    }();
+
+    return table;
+}
+
+Setting* createNode(const SettingDeclaration& declaration, SettingArena& arena)
+{
+    if (declaration.typeId == SettingTypeId::kUnknown)
+    {
+        return arena.create<Item>(declaration.key, declaration.caption, declaration.description);
+    }
+
+    if (declaration.typeId >= SettingTypeId::kCount)
+    {
+        return nullptr;
+    }
+
+    auto createMethod = getCreateMethods()[size_t(declaration.typeId)];
+
+    return createMethod ? createMethod(declaration, arena) : nullptr;
+}
+
+// Children are attached right after creation so key paths are computed once, top-down.
+void buildChildren(Setting* parent, const SettingDeclaration& declaration, SettingArena& arena)
+{
+    auto parentItem = parent->getTypeId() == SettingTypeId::kUnknown
+                          ? static_cast<Item*>(parent)
+                          : nullptr;
+
+    for (const auto& childDeclaration : declaration.children)
+    {
+        if (childDeclaration.typeId == SettingTypeId::kUnknown && !parentItem)
+        {
+            qWarning("Item can't be nested into a setting.");
+            continue;
+        }
+
+        auto child = createNode(childDeclaration, arena);
+
+        if (!child)
+        {
+            qWarning("Unsupported setting type.");
+            continue;
+        }
+
+        if (childDeclaration.typeId == SettingTypeId::kUnknown)
+        {
+            parentItem->addItems({static_cast<Item*>(child)});
+        }
+        else
+        {
+            parent->addSettings({child});
+        }
+
+        buildChildren(child, childDeclaration, arena);
+    }
+}
+
+} // namespace
+
+Item* SettingBuilder::build(const SettingDeclaration& declaration, SettingArena& arena)
+{
+    if (declaration.typeId != SettingTypeId::kUnknown)
+    {
+        qWarning("Root declaration must be an item.");
+        return nullptr;
+    }
+
+    auto root = arena.create<Item>(declaration.key, declaration.caption, declaration.description);
+    buildChildren(root, declaration, arena);
+
+    return root;
+}
+
+Item* SettingBuilder::build(const QJsonObject& description, SettingArena& arena)
+{
+    return build(fromJson(description), arena);
+}
+
+SettingDeclaration SettingBuilder::fromJson(const QJsonObject& description)
+{
+    const auto typeName = description.value("type").toString("item");
+
+    SettingDeclaration declaration;
+    declaration.typeId = typeName == "item" ? SettingTypeId::kUnknown : getTypeId(typeName);
+    declaration.key = description.value("key").toString();
+    declaration.caption = description.value("caption").toString();
+    declaration.description = description.value("description").toString();
+    declaration.value = description.value("value").toVariant();
+    declaration.defaultValue = description.value("default").toVariant();
+    declaration.list = description.value("list").toVariant();
+    declaration.minimum = description.value("minimum").toVariant();
+    declaration.maximum = description.value("maximum").toVariant();
+    declaration.decimals = description.value("decimals").toVariant();
+    declaration.suffix = description.value("suffix").toString();
+    declaration.filters = description.value("filters").toString();
+    declaration.validator = description.value("validator").toString();
+    declaration.isUniqItems = description.value("uniqueItems").toBool();
+
+    const auto sourceType = description.value("sourceType").toString("file");
+    declaration.sourceType = sourceType == "dir" ? DataSource::kDir : DataSource::kFile;
+
+    const auto listType = description.value("listType").toString("string");
+    declaration.listType = listType == "file" ? DataChangeableStringList::kFileList
+                         : listType == "dir"  ? DataChangeableStringList::kDirList
+                                              : DataChangeableStringList::kStringList;
+    declaration.readOnly = description.value("readOnly").toBool();
+
+    const auto children = description.value("children").toArray();
+    declaration.children.reserve(children.size());
+
+    for (const auto& child : children)
+    {
+        declaration.children.push_back(fromJson(child.toObject()));
+    }
+
+    return declaration;
+}
+
+SettingTypeId SettingBuilder::getTypeId(const QString& typeName)
+{
+    static const QHash<QString, SettingTypeId> typeIds = {
+        {"int", SettingTypeId::kInt},
+        {"uint", SettingTypeId::kUInt},
+        {"double", SettingTypeId::kDouble},
+        {"bool", SettingTypeId::kBool},
+        {"string", SettingTypeId::kString},
+        {"stringList", SettingTypeId::kStringList},
+        {"checkList", SettingTypeId::kCheckList},
+        {"byteArray", SettingTypeId::kByteArray},
+        {"font", SettingTypeId::kFont},
+        {"color", SettingTypeId::kColor},
+        {"source", SettingTypeId::kSource},
+        {"dateTime", SettingTypeId::kDateTime},
+        {"editableStringList", SettingTypeId::kEditableStringList},
+        {"checkableStringList", SettingTypeId::kCheckableStringList},
+        {"changeableStringList", SettingTypeId::kChangeableStringList}
+    };
+
+    return typeIds.value(typeName, SettingTypeId::kCount);
+}
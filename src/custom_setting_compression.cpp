@@ -0,0 +1,260 @@
+#include "custom_setting_compression.h"
+#include <QtEndian>
+#include <cstring>
+
+using namespace custom_setting;
+
+namespace
+{
+
+// The magic is followed by length-prefixed compressed chunks up to a zero length.
+const QByteArray kCompressionMagic("CSZ2");
+const int kChunkSize = 64 * 1024;
+const int kMaxCompressedChunkSize = kChunkSize + kChunkSize / 1000 + 64;
+const int kMinCompressedSize = 4 * 1024;
+
+bool readUInt32(QIODevice* device, quint32& value)
+{
+    uchar bytes[sizeof(quint32)];
+
+    if (device->read(reinterpret_cast<char*>(bytes), sizeof(bytes)) != sizeof(bytes))
+    {
+        return false;
+    }
+
+    value = qFromLittleEndian<quint32>(bytes);
+    return true;
+}
+
+bool writeUInt32(QIODevice* device, quint32 value)
+{
+    uchar bytes[sizeof(quint32)];
+    qToLittleEndian(value, bytes);
+
+    return device->write(reinterpret_cast<const char*>(bytes), sizeof(bytes)) == sizeof(bytes);
+}
+
+} // namespace
+
+CompressedDevice::CompressedDevice(QIODevice* device, int level, QObject* parent)
+    : QIODevice(parent)
+    , mDevice(device)
+    , mLevel(level)
+{
+}
+
+bool CompressedDevice::open(OpenMode mode)
+{
+    if (mode != QIODevice::ReadOnly && mode != QIODevice::WriteOnly)
+    {
+        return false;
+    }
+
+    mChunk.clear();
+    mOffset = 0;
+    mIsCompressing = false;
+    mIsFinished = false;
+    mIsValid = true;
+
+    if (mode == QIODevice::ReadOnly)
+    {
+        const auto magic = mDevice->peek(kCompressionMagic.size());
+        mIsCompressing = magic == kCompressionMagic;
+
+        if (mIsCompressing)
+        {
+            mDevice->read(magic.size());
+            readChunk();
+        }
+    }
+
+    return QIODevice::open(mode);
+}
+
+void CompressedDevice::close()
+{
+    if (openMode() & QIODevice::WriteOnly)
+    {
+        if (mIsCompressing)
+        {
+            if ((!mChunk.isEmpty() && !writeChunk(mChunk.size())) || !writeUInt32(mDevice, 0))
+            {
+                mIsValid = false;
+            }
+        }
+        else if (mDevice->write(mChunk) != mChunk.size())
+        {
+            mIsValid = false;
+        }
+
+        mChunk.clear();
+    }
+
+    QIODevice::close();
+}
+
+bool CompressedDevice::isSequential() const
+{
+    return true;
+}
+
+qint64 CompressedDevice::bytesAvailable() const
+{
+    auto available = mIsCompressing ? mChunk.size() - mOffset
+                                    : mDevice->bytesAvailable();
+
+    return available + QIODevice::bytesAvailable();
+}
+
+bool CompressedDevice::isValid() const
+{
+    return mIsValid;
+}
+
+qint64 CompressedDevice::readData(char* data, qint64 maxSize)
+{
+    if (!mIsCompressing)
+    {
+        return mDevice->read(data, maxSize);
+    }
+
+    qint64 total = 0;
+
+    while (total < maxSize && mOffset < mChunk.size())
+    {
+        auto count = qMin<qint64>(maxSize - total, mChunk.size() - mOffset);
+        std::memcpy(data + total, mChunk.constData() + mOffset, size_t(count));
+        total += count;
+        mOffset += int(count);
+
+        if (mOffset == mChunk.size())
+        {
+            readChunk();
+        }
+    }
+
+    return total == 0 && !mIsValid ? -1 : total;
+}
+
+qint64 CompressedDevice::writeData(const char* data, qint64 maxSize)
+{
+    if (mLevel == 0)
+    {
+        return mDevice->write(data, maxSize);
+    }
+
+    mChunk.append(data, int(maxSize));
+
+    // Small payloads stay uncompressed; the container starts once enough data has arrived.
+    if (!mIsCompressing && mChunk.size() >= kMinCompressedSize)
+    {
+        if (mDevice->write(kCompressionMagic) != kCompressionMagic.size())
+        {
+            mIsValid = false;
+            return -1;
+        }
+
+        mIsCompressing = true;
+    }
+
+    while (mIsCompressing && mChunk.size() >= kChunkSize)
+    {
+        if (!writeChunk(kChunkSize))
+        {
+            mIsValid = false;
+            return -1;
+        }
+    }
+
+    return maxSize;
+}
+
+bool CompressedDevice::readChunk()
+{
+    mChunk.clear();
+    mOffset = 0;
+
+    if (mIsFinished)
+    {
+        return false;
+    }
+
+    quint32 length = 0;
+
+    if (!readUInt32(mDevice, length) || length == 0)
+    {
+        mIsFinished = true;
+        return false;
+    }
+
+    if (length < sizeof(quint32) || length > quint32(kMaxCompressedChunkSize))
+    {
+        setInvalid();
+        return false;
+    }
+
+    const auto compressed = mDevice->read(length);
+
+    if (compressed.size() != int(length) ||
+        qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(compressed.constData())) >
+            quint32(kChunkSize))
+    {
+        setInvalid();
+        return false;
+    }
+
+    mChunk = qUncompress(compressed);
+
+    if (mChunk.isEmpty())
+    {
+        setInvalid();
+        return false;
+    }
+
+    return true;
+}
+
+bool CompressedDevice::writeChunk(int size)
+{
+    auto compressed = qCompress(reinterpret_cast<const uchar*>(mChunk.constData()), size, mLevel);
+    mChunk.remove(0, size);
+
+    return writeUInt32(mDevice, quint32(compressed.size())) &&
+           mDevice->write(compressed) == compressed.size();
+}
+
+void CompressedDevice::setInvalid()
+{
+    qWarning("Invalid compressed settings file.");
+    setErrorString(QStringLiteral("Invalid compressed settings file."));
+    mIsValid = false;
+    mIsFinished = true;
+    mChunk.clear();
+    mOffset = 0;
+}
+
+bool Compression::isCompressed(QIODevice* device)
+{
+    const auto magic = device->peek(kCompressionMagic.size());
+
+    return magic == kCompressionMagic;
+}
+
+QByteArray Compression::read(QIODevice* device, qint64 maxSize)
+{
+    if (!isCompressed(device))
+    {
+        return maxSize < 0 ? device->readAll() : device->read(maxSize);
+    }
+
+    CompressedDevice compressed(device);
+
+    if (!compressed.open(QIODevice::ReadOnly))
+    {
+        return {};
+    }
+
+    auto data = maxSize < 0 ? compressed.readAll() : compressed.read(maxSize);
+
+    return compressed.isValid() ? data : QByteArray();
+}
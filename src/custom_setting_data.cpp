@@ -56,3 +56,45 @@ DataCheckableStringList::DataCheckableStringList(const QStringList& lst,
     list(lst)
 {
 }
+
+bool custom_setting::operator==(const DataCheckableStringList& lhs,
+                                const DataCheckableStringList& rhs)
+{
+    return static_cast<const Data<QStringList>&>(lhs) == static_cast<const Data<QStringList>&>(rhs) &&
+           lhs.list == rhs.list;
+}
+
+bool custom_setting::operator==(const DataChangeableStringList& lhs,
+                                const DataChangeableStringList& rhs)
+{
+    return static_cast<const Data<QStringList>&>(lhs) == static_cast<const Data<QStringList>&>(rhs) &&
+           lhs.listType == rhs.listType &&
+           lhs.isUniqItems == rhs.isUniqItems &&
+           lhs.filters == rhs.filters;
+}
+
+bool custom_setting::operator==(const DataInteger& lhs, const DataInteger& rhs)
+{
+    return static_cast<const DataDigit<int>&>(lhs) == static_cast<const DataDigit<int>&>(rhs) &&
+           lhs.suffix == rhs.suffix;
+}
+
+bool custom_setting::operator==(const DataDouble& lhs, const DataDouble& rhs)
+{
+    return static_cast<const DataDigit<double>&>(lhs) == static_cast<const DataDigit<double>&>(rhs) &&
+           lhs.decimals == rhs.decimals &&
+           lhs.suffix == rhs.suffix;
+}
+
+bool custom_setting::operator==(const DataSource& lhs, const DataSource& rhs)
+{
+    return static_cast<const Data<QString>&>(lhs) == static_cast<const Data<QString>&>(rhs) &&
+           lhs.sourceType == rhs.sourceType &&
+           lhs.filters == rhs.filters;
+}
+
+bool custom_setting::operator==(const DataStringMask& lhs, const DataStringMask& rhs)
+{
+    return static_cast<const Data<QString>&>(lhs) == static_cast<const Data<QString>&>(rhs) &&
+           lhs.regexValidatorString == rhs.regexValidatorString;
+}
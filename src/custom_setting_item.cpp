@@ -65,6 +65,60 @@ void Item::removeItem(Item* item)
     }
 }
 
+void Item::moveItem(Item* item, Item* destinationItem, int row)
+{
+    for (auto ancestor = destinationItem; ancestor; ancestor = ancestor->mParentItem)
+    {
+        if (ancestor == item)
+        {
+            qWarning("Item can't be moved into itself.");
+            return;
+        }
+    }
+
+    if (item->mParentItem != this)
+    {
+        return;
+    }
+
+    auto destinationModel = destinationItem->m_model;
+
+    if (m_model == destinationModel)
+    {
+        if (m_model)
+        {
+            m_model->moveItem(this, item, destinationItem, row);
+        }
+        else
+        {
+            moveItemPrivate(item, destinationItem, row);
+        }
+
+        return;
+    }
+
+    // Different models can't share a move, so each one sees its own half.
+    row = qBound(0, row, destinationItem->mItems.size());
+
+    if (m_model)
+    {
+        m_model->takeItem(this, item);
+    }
+    else
+    {
+        takeItemPrivate(item);
+    }
+
+    if (destinationModel)
+    {
+        destinationModel->insertItem(destinationItem, item, row);
+    }
+    else
+    {
+        destinationItem->insertItemPrivate(item, row);
+    }
+}
+
 const Item::List& Item::getItems() const
 {
     return mItems;
@@ -84,16 +138,14 @@ Setting* Item::getSetting(int index)
                : nullptr;
 }
 
-int Item::getNumber() const
+Item* Item::getParentItem() const
 {
-    auto parentItem = dynamic_cast<Item*>(parent());
-
-    if (parentItem)
-    {
-        return parentItem->mItems.indexOf(const_cast<Item*>(this));
-    }
+    return mParentItem;
+}
 
-    return 0;
+int Item::getNumber() const
+{
+    return mRow;
 }
 
 ItemTreeModel* Item::getModel() const
@@ -124,29 +176,147 @@ void Item::clearItems()
 
 void Item::addItemsPrivate(const List& items)
 {
+    auto first = mItems.size();
     mItems.append(items);
+    updateRows(first);
 
     for (auto& item : items)
     {
-        item->setParent(this);
+        item->mParentItem = this;
+        item->setParentSetting(this);
+        item->setManager(mManager);
         item->setModel(m_model);
+    }
+}
 
-        connect(item, &Item::signalDataChanged, this, &Item::signalDataChanged);
+void Item::updateKeyPath()
+{
+    Setting::updateKeyPath();
+
+    for (auto& item : mItems)
+    {
+        item->updateKeyPath();
+    }
+}
+
+void Item::setManager(Manager* manager)
+{
+    Setting::setManager(manager);
+
+    for (auto& item : mItems)
+    {
+        item->setManager(manager);
     }
 }
 
 void Item::setItemsPrivate(const List& items)
 {
+    for (auto& item : mItems)
+    {
+        item->detachPrivate();
+    }
+
     mItems.clear();
     addItemsPrivate(items);
 }
 
 void Item::removeItemPrivate(Item* item)
 {
-    mItems.removeOne(item);
+    if (item->mParentItem != this)
+    {
+        return;
+    }
+
+    auto row = item->mRow;
+    mItems.removeAt(row);
+    updateRows(row);
+
+    item->detachPrivate();
+}
+
+void Item::moveItemPrivate(Item* item, Item* destinationItem, int row)
+{
+    if (item->mParentItem != this)
+    {
+        return;
+    }
+
+    auto sourceRow = item->mRow;
+    row = qBound(0, row, destinationItem->mItems.size());
+
+    if (destinationItem == this && row > sourceRow)
+    {
+        --row;
+    }
+
+    mItems.removeAt(sourceRow);
+    destinationItem->mItems.insert(row, item);
+
+    if (destinationItem == this)
+    {
+        updateRows(qMin(sourceRow, row));
+    }
+    else
+    {
+        updateRows(sourceRow);
+        destinationItem->updateRows(row);
+        item->mParentItem = destinationItem;
+        item->setParentSetting(destinationItem);
+        item->setManager(destinationItem->mManager);
+        item->setModel(destinationItem->m_model);
+    }
+}
+
+void Item::takeItemPrivate(Item* item)
+{
+    if (item->mParentItem != this)
+    {
+        return;
+    }
+
+    auto row = item->mRow;
+    mItems.removeAt(row);
+    updateRows(row);
+
+    item->mParentItem = nullptr;
+    item->mRow = 0;
+}
+
+void Item::insertItemPrivate(Item* item, int row)
+{
+    row = qBound(0, row, mItems.size());
+    mItems.insert(row, item);
+    updateRows(row);
+
+    item->mParentItem = this;
+    item->setParentSetting(this);
+    item->setManager(mManager);
+    item->setModel(m_model);
 }
 
 void Item::clearPrivat()
 {
+    for (auto& item : mItems)
+    {
+        item->detachPrivate();
+    }
+
     mItems.clear();
 }
+
+void Item::detachPrivate()
+{
+    mParentItem = nullptr;
+    mRow = 0;
+    setManager(nullptr);
+    setModel(nullptr);
+    setParentSetting(nullptr);
+}
+
+void Item::updateRows(int first)
+{
+    for (int row = first; row < mItems.size(); ++row)
+    {
+        mItems[row]->mRow = row;
+    }
+}
@@ -61,8 +61,9 @@ QSize Delegate::sizeHint(const QStyleOptionViewItem &option,
         {
             int heightHint;
             auto setting = index.data().value<Setting*>();
-            heightHint = dynamic_cast<SettingEditableStringList*>(setting) ||
-                         dynamic_cast<SettingCheckableStringList*>(setting)
+            auto typeId = setting ? setting->getTypeId() : SettingTypeId::kUnknown;
+            heightHint = typeId == SettingTypeId::kEditableStringList ||
+                         typeId == SettingTypeId::kCheckableStringList
                              ? mItemHeight * mItemsRowsCount
                              : mItemHeight;
             sHint.setHeight(heightHint);
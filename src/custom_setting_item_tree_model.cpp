@@ -117,6 +117,16 @@ Item* ItemTreeModel::getItem(const QModelIndex& index) const
     return static_cast<Item*>(index.internalPointer());
 }
 
+QModelIndex ItemTreeModel::getIndex(Item* item) const
+{
+    if (!item || item == mRootItem)
+    {
+        return QModelIndex();
+    }
+
+    return createIndex(item->getNumber(), 0, item);
+}
+
 Setting *ItemTreeModel::getSetting(const QModelIndex& index) const
 {
     if (!index.isValid())
@@ -169,9 +179,9 @@ QModelIndex ItemTreeModel::parent(const QModelIndex& index) const
         return QModelIndex();
     }
 
-    auto mParent = dynamic_cast<Item*>(childItem->parent());
+    auto mParent = childItem->getParentItem();
 
-    if (mParent == mRootItem)
+    if (!mParent || mParent == mRootItem)
     {
         return QModelIndex();
     }
@@ -198,45 +208,116 @@ void ItemTreeModel::setRootItem(Item* item)
     mRootItem->setModel(this);
     mRootItem->setParent(this);
 
-    connect(mRootItem, &Item::signalDataChanged, this, &ItemTreeModel::refresh);
+    connect(mRootItem, &Item::signalSettingChanged, this, &ItemTreeModel::onSettingChanged);
 
     endResetModel();
 }
 
 void ItemTreeModel::addItems(Item* parentItem, const Item::List& items)
 {
-    beginResetModel();
+    if (items.isEmpty())
+    {
+        return;
+    }
+
+    auto first = parentItem->getItems().size();
+    beginInsertRows(getIndex(parentItem), first, first + items.size() - 1);
 
     parentItem->addItemsPrivate(items);
 
-    endResetModel();
+    endInsertRows();
 }
 
 void ItemTreeModel::setItems(Item* parentItem, const Item::List& items)
 {
-    beginResetModel();
+    auto count = parentItem->getItems().size();
 
-    parentItem->setItemsPrivate(items);
+    if (count > 0)
+    {
+        beginRemoveRows(getIndex(parentItem), 0, count - 1);
 
-    endResetModel();
+        parentItem->setItemsPrivate({});
+
+        endRemoveRows();
+    }
+
+    addItems(parentItem, items);
 }
 
 void ItemTreeModel::removeItem(Item* parentItem, Item* item)
 {
-    beginResetModel();
+    if (item->getParentItem() != parentItem)
+    {
+        return;
+    }
+
+    auto row = item->getNumber();
+    beginRemoveRows(getIndex(parentItem), row, row);
 
     parentItem->removeItemPrivate(item);
 
-    endResetModel();
+    endRemoveRows();
+}
+
+void ItemTreeModel::moveItem(Item* parentItem, Item* item, Item* destinationItem, int row)
+{
+    if (item->getParentItem() != parentItem)
+    {
+        return;
+    }
+
+    auto sourceRow = item->getNumber();
+    row = qBound(0, row, destinationItem->getItems().size());
+
+    if (!beginMoveRows(getIndex(parentItem), sourceRow, sourceRow, getIndex(destinationItem), row))
+    {
+        return;
+    }
+
+    parentItem->moveItemPrivate(item, destinationItem, row);
+
+    endMoveRows();
+}
+
+void ItemTreeModel::takeItem(Item* parentItem, Item* item)
+{
+    if (item->getParentItem() != parentItem)
+    {
+        return;
+    }
+
+    auto row = item->getNumber();
+    beginRemoveRows(getIndex(parentItem), row, row);
+
+    parentItem->takeItemPrivate(item);
+
+    endRemoveRows();
+}
+
+void ItemTreeModel::insertItem(Item* parentItem, Item* item, int row)
+{
+    row = qBound(0, row, parentItem->getItems().size());
+    beginInsertRows(getIndex(parentItem), row, row);
+
+    parentItem->insertItemPrivate(item, row);
+
+    endInsertRows();
 }
 
 void ItemTreeModel::clearItems(Item* parentItem)
 {
-    beginResetModel();
+    auto count = parentItem->getItems().size();
+
+    if (count == 0)
+    {
+        return;
+    }
 
-    parentItem->clearItems();
+    beginRemoveRows(getIndex(parentItem), 0, count - 1);
 
-    endResetModel();
+    parentItem->clearPrivat();
+
+    endRemoveRows();
 }
 
 void ItemTreeModel::setSettingValue(const QModelIndex& index, const QVariant& value)
@@ -288,6 +369,11 @@ void ItemTreeModel::itemEditionStarted()
 void ItemTreeModel::itemEditionFinished()
 {
     mIsItemEditing = false;
+
+    if (!mChangedSettings.isEmpty())
+    {
+        scheduleFlush();
+    }
 }
 
 const QStringList& ItemTreeModel::getHeaders()
@@ -303,6 +389,85 @@ void ItemTreeModel::refresh()
     }
 }
 
+void ItemTreeModel::onSettingChanged(Setting* setting)
+{
+    mChangedSettings.insert(setting, setting);
+    scheduleFlush();
+}
+
+void ItemTreeModel::scheduleFlush()
+{
+    if (mIsItemEditing || mIsFlushScheduled)
+    {
+        return;
+    }
+
+    mIsFlushScheduled = true;
+    QMetaObject::invokeMethod(this, &ItemTreeModel::flushChanges, Qt::QueuedConnection);
+}
+
+void ItemTreeModel::flushChanges()
+{
+    mIsFlushScheduled = false;
+
+    if (mIsItemEditing)
+    {
+        return;
+    }
+
+    QHash<Item*, QPair<int, int>> changedColumns;
+
+    for (const auto& setting : qAsConst(mChangedSettings))
+    {
+        if (!setting)
+        {
+            continue;
+        }
+
+        // A cell shows a direct setting of its row item; nested settings repaint that cell.
+        Setting* cellSetting = setting;
+        auto item = qobject_cast<Item*>(cellSetting);
+
+        while (!item && cellSetting->getParentSetting())
+        {
+            item = qobject_cast<Item*>(cellSetting->getParentSetting());
+
+            if (!item)
+            {
+                cellSetting = cellSetting->getParentSetting();
+            }
+        }
+
+        if (!item || !item->getParentItem() || item->getModel() != this)
+        {
+            continue;
+        }
+
+        auto column = cellSetting == item ? 0 : item->getSettings().indexOf(cellSetting) + 1;
+        auto it = changedColumns.find(item);
+
+        if (it == changedColumns.end())
+        {
+            changedColumns.insert(item, {column, column});
+        }
+        else
+        {
+            it->first = qMin(it->first, column);
+            it->second = qMax(it->second, column);
+        }
+    }
+
+    mChangedSettings.clear();
+
+    for (auto it = changedColumns.cbegin(); it != changedColumns.cend(); ++it)
+    {
+        auto row = it.key()->getNumber();
+
+        emit dataChanged(createIndex(row, it->first, it.key()),
+                         createIndex(row, it->second, it.key()));
+    }
+}
+
 void ItemTreeModel::setDataChangeModel(DataChangeMode dataChangeModel)
 {
     mDataChangeModel = dataChangeModel;
@@ -0,0 +1,308 @@
+#include "custom_setting_journal.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QtEndian>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace custom_setting;
+
+namespace
+{
+
+const char kJournalMagic[] = {'C', 'S', 'J', '2'};
+const qint64 kJournalHeaderSize = 20;
+const qint64 kRecordHeaderSize = 6;
+const QDataStream::Version kJournalStreamVersion = QDataStream::Qt_5_12;
+
+void appendRecord(QByteArray& buffer, const QString& key, const QVariant& value)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(kJournalStreamVersion);
+    stream << key << value;
+
+    uchar header[kRecordHeaderSize];
+    qToLittleEndian<quint32>(payload.size(), header);
+    qToLittleEndian<quint16>(qChecksum(payload.constData(), payload.size()), header + 4);
+
+    buffer.append(reinterpret_cast<const char*>(header), sizeof(header));
+    buffer.append(payload);
+}
+
+bool syncFile(QFile& file)
+{
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+} // namespace
+
+SerializerJournal::SerializerJournal(Serializer* base, Mode mode, QObject* parent)
+    : Serializer(base->getFilename(), mode, parent)
+    , mBase(base)
+    , mJournalPath(getJournalPath(base->getFilename()))
+{
+    mBase->setParent(this);
+
+    if (mMode != Mode::kRead)
+    {
+        return;
+    }
+
+    QFile file(mJournalPath);
+
+    if (file.open(QIODevice::ReadOnly) && file.read(kJournalHeaderSize) == createHeader())
+    {
+        file.seek(0);
+        readRecords(file.readAll(), &mReplayed);
+    }
+}
+
+void SerializerJournal::setValue(const KeyPath& path,
+                                 const QVariant& value,
+                                 bool asPlainValue)
+{
+    if (mIsCompacting)
+    {
+        mBase->setValue(path, value, asPlainValue);
+    }
+    else
+    {
+        mPending.insert(path.key, value);
+    }
+}
+
+QVariant SerializerJournal::getValue(const KeyPath& path,
+                                     const QVariant& defaultValue,
+                                     bool asPlainValue)
+{
+    auto it = mReplayed.constFind(path.key);
+
+    if (it != mReplayed.constEnd())
+    {
+        return *it;
+    }
+
+    return mBase->getValue(path, defaultValue, asPlainValue);
+}
+
+bool SerializerJournal::readValue(const KeyPath& path, ValueVisitor& visitor)
+{
+    auto it = mReplayed.constFind(path.key);
+
+    if (it != mReplayed.constEnd())
+    {
+        visitor.visit(QVariant(*it));
+        return true;
+    }
+
+    return mBase->readValue(path, visitor);
+}
+
+bool SerializerJournal::sync()
+{
+    return mIsCompacting ? compact() : append();
+}
+
+bool SerializerJournal::isPartialWriteSupported() const
+{
+    return !mIsCompacting;
+}
+
+void SerializerJournal::reset()
+{
+    mPending.clear();
+    mBase->reset();
+    mIsCompacting = false;
+}
+
+void SerializerJournal::setCompacting(bool isCompacting)
+{
+    mIsCompacting = isCompacting;
+}
+
+bool SerializerJournal::isCompacting() const
+{
+    return mIsCompacting;
+}
+
+qint64 SerializerJournal::getJournalSize() const
+{
+    QFileInfo info(mJournalPath);
+
+    return info.exists() ? info.size() : 0;
+}
+
+QString SerializerJournal::getJournalPath(const QString& filename)
+{
+    return filename + ".journal";
+}
+
+Serializer* SerializerJournal::create(const QString& filename, Mode mode, QObject* parent)
+{
+    auto base = Serializer::create(filename, mode);
+
+    return base ? new SerializerJournal(base, mode, parent) : nullptr;
+}
+
+qint64 SerializerJournal::readRecords(const QByteArray& data,
+                                      QHash<QString, QVariant>* values) const
+{
+    auto bytes = reinterpret_cast<const uchar*>(data.constData());
+    qint64 offset = kJournalHeaderSize;
+
+    while (data.size() - offset >= kRecordHeaderSize)
+    {
+        auto length = qFromLittleEndian<quint32>(bytes + offset);
+        auto checksum = qFromLittleEndian<quint16>(bytes + offset + 4);
+        auto payloadOffset = offset + kRecordHeaderSize;
+
+        if (length > data.size() - payloadOffset ||
+            qChecksum(data.constData() + payloadOffset, length) != checksum)
+        {
+            break;
+        }
+
+        if (values)
+        {
+            QDataStream stream(data.mid(payloadOffset, length));
+            stream.setVersion(kJournalStreamVersion);
+
+            QString key;
+            QVariant value;
+            stream >> key >> value;
+
+            if (stream.status() != QDataStream::Ok)
+            {
+                break;
+            }
+
+            values->insert(key, value);
+        }
+
+        offset = payloadOffset + length;
+    }
+
+    return offset;
+}
+
+// The base file is stamped by its content, so copying or touching it keeps the journal valid.
+// The hash is only recomputed when the file's size or modification time changes.
+QByteArray SerializerJournal::createHeader() const
+{
+    QFileInfo info(mFilename);
+    const auto size = info.exists() ? info.size() : -1;
+    const auto lastModified = info.lastModified();
+
+    if (!mHeader.isEmpty() && size == mBaseSize && lastModified == mBaseModified)
+    {
+        return mHeader;
+    }
+
+    QByteArray hash(sizeof(qint64), '\0');
+    QFile file(mFilename);
+
+    if (file.open(QIODevice::ReadOnly))
+    {
+        QCryptographicHash generator(QCryptographicHash::Sha1);
+        generator.addData(&file);
+        hash = generator.result().left(sizeof(qint64));
+    }
+
+    uchar stamp[sizeof(qint64)];
+    qToLittleEndian<qint64>(size, stamp);
+
+    mHeader = QByteArray(kJournalMagic, sizeof(kJournalMagic));
+    mHeader.append(reinterpret_cast<const char*>(stamp), sizeof(stamp));
+    mHeader.append(hash);
+    mBaseSize = size;
+    mBaseModified = lastModified;
+
+    return mHeader;
+}
+
+bool SerializerJournal::append()
+{
+    if (mPending.isEmpty())
+    {
+        return true;
+    }
+
+    QFile file(mJournalPath);
+
+    if (!file.open(QIODevice::ReadWrite))
+    {
+        qWarning("Couldn't open file.");
+        return false;
+    }
+
+    const auto header = createHeader();
+
+    if (file.read(kJournalHeaderSize) != header)
+    {
+        if (!file.resize(0) || !file.seek(0) || file.write(header) != header.size())
+        {
+            mJournalEnd = -1;
+            return false;
+        }
+
+        mJournalEnd = header.size();
+    }
+    else if (file.size() != mJournalEnd)
+    {
+        file.seek(0);
+        mJournalEnd = readRecords(file.readAll(), nullptr);
+
+        if (!file.resize(mJournalEnd))
+        {
+            mJournalEnd = -1;
+            return false;
+        }
+    }
+
+    QByteArray records;
+
+    for (auto it = mPending.cbegin(); it != mPending.cend(); ++it)
+    {
+        appendRecord(records, it.key(), it.value());
+    }
+
+    if (!file.seek(mJournalEnd) ||
+        file.write(records) != records.size() ||
+        !file.flush() ||
+        (mSyncPolicy != SyncPolicy::kNone && !syncFile(file)))
+    {
+        mJournalEnd = -1;
+        return false;
+    }
+
+    mJournalEnd += records.size();
+    mPending.clear();
+
+    return true;
+}
+
+bool SerializerJournal::compact()
+{
+    mBase->setSyncPolicy(mSyncPolicy);
+    mBase->setCompressionLevel(mCompressionLevel);
+
+    if (!mBase->sync())
+    {
+        return false;
+    }
+
+    QFile::remove(mJournalPath);
+    mJournalEnd = -1;
+    mHeader.clear();
+
+    return true;
+}
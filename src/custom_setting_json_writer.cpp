@@ -0,0 +1,205 @@
+#include "custom_setting_json_writer.h"
+#include <QJsonArray>
+#include <QJsonObject>
+#include <iterator>
+
+using namespace custom_setting;
+
+namespace
+{
+
+char hexDigit(uint value)
+{
+    return char(value < 0xa ? '0' + value : 'a' + value - 0xa);
+}
+
+} // namespace
+
+JsonStreamWriter::JsonStreamWriter(QIODevice* device,
+                                   QJsonDocument::JsonFormat format)
+    : mDevice(device)
+    , mIsCompact(format == QJsonDocument::Compact)
+{}
+
+bool JsonStreamWriter::write(const ValueTree& tree)
+{
+    const auto& root = tree.getRoot();
+
+    if (root.children.isEmpty())
+    {
+        writeRaw(mIsCompact ? "{}" : "{\n}\n");
+        return mIsOk;
+    }
+
+    writeNode(tree, root, 0);
+
+    if (!mIsCompact)
+    {
+        writeRaw("\n");
+    }
+
+    return mIsOk;
+}
+
+void JsonStreamWriter::writeNode(const ValueTree& tree,
+                                 const ValueTree::Node& node,
+                                 int indent)
+{
+    if (node.children.isEmpty())
+    {
+        writeValue(QJsonValue::fromVariant(node.value), indent);
+        return;
+    }
+
+    writeRaw(mIsCompact ? "{" : "{\n");
+
+    if (node.value.isValid())
+    {
+        writeIndent(indent + 1);
+        writeString(QLatin1String(ValueTree::kValueKey));
+        writeRaw(mIsCompact ? ":" : ": ");
+        writeValue(QJsonValue::fromVariant(node.value), indent + 1);
+        writeSeparator(false);
+    }
+
+    for (auto it = node.children.cbegin(); it != node.children.cend(); ++it)
+    {
+        writeIndent(indent + 1);
+        writeString(it.key());
+        writeRaw(mIsCompact ? ":" : ": ");
+        writeNode(tree, tree.getNode(it.value()), indent + 1);
+        writeSeparator(std::next(it) == node.children.cend());
+    }
+
+    writeIndent(indent);
+    writeRaw("}");
+}
+
+void JsonStreamWriter::writeValue(const QJsonValue& value, int indent)
+{
+    switch (value.type())
+    {
+    case QJsonValue::Bool:
+        writeRaw(value.toBool() ? "true" : "false");
+        break;
+
+    case QJsonValue::String:
+        writeString(value.toString());
+        break;
+
+    case QJsonValue::Double:
+    {
+        auto json = QJsonDocument(QJsonArray{value}).toJson(QJsonDocument::Compact);
+        writeRaw(json.mid(1, json.size() - 2));
+        break;
+    }
+
+    case QJsonValue::Array:
+    {
+        auto array = value.toArray();
+        writeRaw(mIsCompact ? "[" : "[\n");
+
+        for (int i = 0; i < array.size(); ++i)
+        {
+            writeIndent(indent + 1);
+            writeValue(array.at(i), indent + 1);
+            writeSeparator(i == array.size() - 1);
+        }
+
+        writeIndent(indent);
+        writeRaw("]");
+        break;
+    }
+
+    case QJsonValue::Object:
+    {
+        auto obj = value.toObject();
+        writeRaw(mIsCompact ? "{" : "{\n");
+
+        for (auto it = obj.constBegin(); it != obj.constEnd(); ++it)
+        {
+            writeIndent(indent + 1);
+            writeString(it.key());
+            writeRaw(mIsCompact ? ":" : ": ");
+            writeValue(it.value(), indent + 1);
+            writeSeparator(std::next(it) == obj.constEnd());
+        }
+
+        writeIndent(indent);
+        writeRaw("}");
+        break;
+    }
+
+    default:
+        writeRaw("null");
+        break;
+    }
+}
+
+void JsonStreamWriter::writeString(const QString& string)
+{
+    auto utf8 = string.toUtf8();
+    QByteArray json;
+    json.reserve(utf8.size() + 2);
+    json += '"';
+
+    for (auto ch : utf8)
+    {
+        auto u = uchar(ch);
+
+        if (u >= 0x20 && u != '"' && u != '\\')
+        {
+            json += ch;
+            continue;
+        }
+
+        json += '\\';
+
+        switch (u)
+        {
+        case '"':  json += '"';  break;
+        case '\\': json += '\\'; break;
+        case '\b': json += 'b';  break;
+        case '\f': json += 'f';  break;
+        case '\n': json += 'n';  break;
+        case '\r': json += 'r';  break;
+        case '\t': json += 't';  break;
+        default:
+            json += "u00";
+            json += hexDigit(u >> 4);
+            json += hexDigit(u & 0xf);
+            break;
+        }
+    }
+
+    json += '"';
+    writeRaw(json);
+}
+
+void JsonStreamWriter::writeIndent(int indent)
+{
+    if (!mIsCompact)
+    {
+        writeRaw(QByteArray(4 * indent, ' '));
+    }
+}
+
+void JsonStreamWriter::writeSeparator(bool isLast)
+{
+    if (isLast)
+    {
+        writeRaw(mIsCompact ? "" : "\n");
+    }
+    else
+    {
+        writeRaw(mIsCompact ? "," : ",\n");
+    }
+}
+
+void JsonStreamWriter::writeRaw(const QByteArray& data)
+{
+    if (mIsOk && !data.isEmpty() && mDevice->write(data) != data.size())
+    {
+        mIsOk = false;
+    }
+}
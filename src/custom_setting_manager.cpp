@@ -1,49 +1,417 @@
+#include <QtConcurrent>
+#include <QPointer>
+#include <QThread>
+#include <memory>
+#include <numeric>
 #include "custom_setting_manager.h"
 #include "custom_setting_serializer.h"
+#include "custom_setting_journal.h"
 #include "custom_setting.h"
 
 using namespace custom_setting;
 
+namespace
+{
+
+Serializer* createConfigurationSerializer(const QString& path,
+                                          Serializer::Mode mode,
+                                          bool isJournaled)
+{
+    if (isJournaled ||
+        (mode == Serializer::Mode::kRead &&
+         QFileInfo::exists(SerializerJournal::getJournalPath(path))))
+    {
+        return SerializerJournal::create(path, mode);
+    }
+
+    return Serializer::create(path, mode);
+}
+
+Serializer* parseConfiguration(const QString& path, QThread* thread, bool isJournaled)
+{
+    auto serializer = createConfigurationSerializer(path, Serializer::Mode::kRead, isJournaled);
+
+    if (serializer)
+    {
+        serializer->moveToThread(thread);
+    }
+
+    return serializer;
+}
+
+std::function<int(int)> createParser(const QStringList& files,
+                                     const QString& dirPath,
+                                     QThread* thread,
+                                     bool isJournaled,
+                                     std::shared_ptr<Serializer>* results)
+{
+    return [files, dirPath, thread, isJournaled, results](int index) {
+        results[index].reset(parseConfiguration(dirPath + files.at(index),
+                                                thread,
+                                                isJournaled));
+        return index;
+    };
+}
+
+} // namespace
+
 Manager::Manager(QObject* parent) : QObject(parent)
-{}
+{
+    connect(&mLoadWatcher, &QFutureWatcher<int>::resultReadyAt,
+            this, &Manager::onLoadResultReady);
+    connect(&mLoadWatcher, &QFutureWatcher<int>::finished,
+            this, &Manager::onLoadFinished);
+    connect(&mSaveWatcher, &QFutureWatcher<QStringList>::finished,
+            this, &Manager::onSaveFinished);
+
+    mReloadTimer.setSingleShot(true);
+    mReloadTimer.setInterval(500);
+
+    connect(&mReloadTimer, &QTimer::timeout,
+            this, &Manager::reloadChangedFiles);
+    connect(&mFileWatcher, &QFileSystemWatcher::fileChanged,
+            this, &Manager::onFileChanged);
+    connect(&mFileWatcher, &QFileSystemWatcher::directoryChanged,
+            this, &Manager::onWatchedPathChanged);
+
+    mSnapshotTimer.setSingleShot(true);
+
+    connect(&mSnapshotTimer, &QTimer::timeout,
+            this, &Manager::publishSnapshot);
+    connect(this, &Manager::signalDataChanged,
+            this, &Manager::scheduleSnapshot);
+    connect(this, &Manager::signalDataLoaded,
+            this, &Manager::scheduleSnapshot);
+}
+
+Manager::~Manager()
+{
+    mLoadWatcher.cancel();
+    mLoadWatcher.waitForFinished();
+    mSaveWatcher.waitForFinished();
+
+    for (auto& setting : mManagedSettings)
+    {
+        setting->mManager = nullptr;
+    }
+}
 
 void Manager::loadConfigurations()
 {
-    for (auto& filename : mConfigurations.keys())
+    const auto filenames = mConfigurations.keys();
+    QVector<std::shared_ptr<Serializer>> serializers;
+    QVector<SerializerCache::Stamp> stamps;
+    auto indexes = getUncachedReaders(filenames, serializers, stamps);
+
+    QtConcurrent::blockingMap(indexes, createParser(filenames,
+                                                    getSettingsDirPath(),
+                                                    QThread::currentThread(),
+                                                    mPersistenceMode == PersistenceMode::kJournal,
+                                                    serializers.data()));
+
+    for (int i = 0; i < filenames.size(); ++i)
     {
-        auto serializer =
-            Serializer::create(getSettingsDirPath() + filename,
-                               Serializer::Mode::kRead,
-                               parent());
-        if (serializer)
+        applyLoaded(filenames.at(i), serializers.at(i), stamps.at(i));
+    }
+
+    emit signalDataLoaded();
+}
+
+QFuture<void> Manager::loadConfigurationsAsync()
+{
+    if (mLoadWatcher.isRunning())
+    {
+        return mLoadWatcher.future();
+    }
+
+    mLoadingFiles = mConfigurations.keys();
+    mLoadedCount = 0;
+
+    auto indexes = getUncachedReaders(mLoadingFiles, mLoadedSerializers, mLoadedStamps);
+
+    for (int i = 0; i < mLoadingFiles.size(); ++i)
+    {
+        if (mLoadedSerializers.at(i))
         {
-            mConfigurations[filename]->load(serializer);
+            applyLoaded(mLoadingFiles.at(i), mLoadedSerializers.at(i), mLoadedStamps.at(i));
+            mLoadedSerializers[i].reset();
+
+            emit signalLoadProgress(++mLoadedCount, mLoadingFiles.size());
         }
     }
 
-    emit signalDataLoaded();
+    mLoadWatcher.setFuture(QtConcurrent::mapped(indexes,
+                                                createParser(mLoadingFiles,
+                                                             getSettingsDirPath(),
+                                                             thread(),
+                                                             mPersistenceMode == PersistenceMode::kJournal,
+                                                             mLoadedSerializers.data())));
+
+    return mLoadWatcher.future();
+}
+
+void Manager::cancelLoading()
+{
+    mLoadWatcher.cancel();
+}
+
+bool Manager::isLoading() const
+{
+    return mLoadWatcher.isRunning();
 }
 
 void Manager::saveConfigurations()
 {
+    if (mSaveMode == SaveMode::kAsync)
+    {
+        saveConfigurationsAsync();
+        return;
+    }
+
+    bool isOk = true;
+
     for (auto& filename : mConfigurations.keys())
     {
-        auto serializer =
-            Serializer::create(getSettingsDirPath() + filename,
-                               Serializer::Mode::kWrite,
-                               this);
-        if (serializer)
+        auto serializer = prepareSave(filename);
+
+        if (!serializer)
+        {
+            continue;
+        }
+
+        if (serializer->sync())
+        {
+            onFileSaved(filename);
+        }
+        else
         {
-            mConfigurations[filename]->save(serializer);
-            serializer->sync();
+            mUnsavedFiles.insert(filename);
+            isOk = false;
         }
     }
+
+    emit signalDataSaved(isOk);
 }
 
 void Manager::deleteConfiguration(const QString& filename)
 {
-    mConfigurations.remove(filename);
+    if (auto setting = mConfigurations.take(filename))
+    {
+        setting->setManager(nullptr);
+    }
+
+    mSerializerCache.remove(getSettingsDirPath() + filename);
     remove((getSettingsDirPath() + filename).toStdString().c_str());
+    QFile::remove(SerializerJournal::getJournalPath(getSettingsDirPath() + filename));
+}
+
+void Manager::setSaveMode(SaveMode mode)
+{
+    mSaveMode = mode;
+}
+
+void Manager::setSyncPolicy(Serializer::SyncPolicy policy)
+{
+    mSyncPolicy = policy;
+}
+
+bool Manager::isSaving() const
+{
+    return mSaveWatcher.isRunning();
+}
+
+void Manager::setPersistenceMode(PersistenceMode mode)
+{
+    if (mPersistenceMode == mode)
+    {
+        return;
+    }
+
+    mPersistenceMode = mode;
+    mSerializerCache.setWriterFactory(mode == PersistenceMode::kJournal
+                                      ? Serializer::Factory(&SerializerJournal::create)
+                                      : Serializer::Factory(&Serializer::create));
+}
+
+void Manager::setJournalCompactionSize(qint64 size)
+{
+    mJournalCompactionSize = size;
+}
+
+void Manager::compactConfigurations()
+{
+    for (const auto& filename : mConfigurations.keys())
+    {
+        mUnsavedFiles.insert(filename);
+    }
+
+    saveConfigurations();
+}
+
+void Manager::setCompressionLevel(const QString& filename, int level)
+{
+    if (mCompressionLevels.value(filename) == level)
+    {
+        return;
+    }
+
+    mCompressionLevels.insert(filename, level);
+    mUnsavedFiles.insert(filename);
+}
+
+void Manager::beginTransaction()
+{
+    ++mTransactionDepth;
+}
+
+void Manager::commitTransaction()
+{
+    if (mTransactionDepth == 0 || --mTransactionDepth > 0)
+    {
+        return;
+    }
+
+    // Slots may delete settings while the changes are announced.
+    QVector<QPointer<Setting>> changes;
+    changes.reserve(mTransactionChanges.size());
+
+    for (auto& setting : mTransactionChanges)
+    {
+        changes.append(setting);
+    }
+
+    mTransactionChanges.clear();
+    mChangedSettings.clear();
+
+    QSet<Setting*> notifiedSettings;
+    QStringList keys;
+
+    // Every changed setting and ancestor later gets the keys changed in its own subtree.
+    QVector<QPointer<Setting>> affectedSettings;
+    QHash<Setting*, QStringList> affectedKeys;
+
+    for (auto& setting : changes)
+    {
+        if (!setting)
+        {
+            continue;
+        }
+
+        const auto& key = setting->getKeyPath().key;
+
+        for (auto it = setting.data(); it; it = it->mParentSetting)
+        {
+            auto& subtreeKeys = affectedKeys[it];
+
+            if (subtreeKeys.isEmpty())
+            {
+                affectedSettings.append(it);
+            }
+
+            subtreeKeys.append(key);
+        }
+    }
+
+    for (auto& setting : changes)
+    {
+        if (!setting)
+        {
+            continue;
+        }
+
+        const auto value = setting->getValue();
+        keys.append(setting->getKeyPath().key);
+        markSnapshotChanged(setting);
+        notifiedSettings.insert(setting);
+        emit setting->signalDataChanged(value);
+    }
+
+    for (auto& setting : changes)
+    {
+        if (!setting)
+        {
+            continue;
+        }
+
+        const auto value = setting->getValue();
+        QPointer<Setting> it = setting->mParentSetting;
+
+        while (it && !notifiedSettings.contains(it))
+        {
+            notifiedSettings.insert(it);
+            emit it->signalDataChanged(value);
+            it = it ? it->mParentSetting : nullptr;
+        }
+
+        it = setting.data();
+
+        while (it && setting)
+        {
+            emit it->signalSettingChanged(setting);
+            it = it ? it->mParentSetting : nullptr;
+        }
+    }
+
+    for (auto& setting : affectedSettings)
+    {
+        if (setting)
+        {
+            emit setting->signalTransactionCommitted(affectedKeys.value(setting.data()));
+        }
+    }
+
+    if (!keys.isEmpty())
+    {
+        if (mIsSnapshotEnabled)
+        {
+            publishSnapshot();
+        }
+
+        emit signalTransactionCommitted(keys);
+    }
+}
+
+bool Manager::isInTransaction() const
+{
+    return mTransactionDepth > 0;
+}
+
+void Manager::setSnapshotEnabled(bool isEnabled)
+{
+    mIsSnapshotEnabled = isEnabled;
+
+    if (mIsSnapshotEnabled)
+    {
+        mIsSnapshotRebuildNeeded = true;
+        publishSnapshot();
+    }
+    else
+    {
+        mSnapshotTimer.stop();
+        mSnapshotValues.clear();
+        mSnapshotChanges.clear();
+    }
+}
+
+SnapshotPublisher::Handle Manager::getSnapshot() const
+{
+    return mSnapshotPublisher.acquire();
+}
+
+Setting* Manager::findSetting(const QString& path) const
+{
+    return mSettingIndex.value(path);
+}
+
+void Manager::setHotReloadEnabled(bool isEnabled)
+{
+    mIsHotReloadEnabled = isEnabled;
+    updateWatchedFiles();
+}
+
+void Manager::setHotReloadDelay(int msec)
+{
+    mReloadTimer.setInterval(msec);
 }
 
 QString Manager::getSettingsDirPath() const
@@ -53,10 +421,493 @@ QString Manager::getSettingsDirPath() const
 
 void Manager::setConfigurations(const Manager::ConfigurationsMap& configurations)
 {
+    for (auto& setting : mConfigurations)
+    {
+        setting->setManager(nullptr);
+    }
+
     mConfigurations = configurations;
     for (auto& setting : mConfigurations)
     {
+        setting->setKeyRoot(true);
+        setting->setManager(this);
         connect(setting, &Setting::signalDataChanged,
                 this, &Manager::signalDataChanged);
     }
+
+    updateWatchedFiles();
+    scheduleSnapshot();
+}
+
+Serializer* Manager::createSerializer(const QString& filename,
+                                      Serializer::Mode mode) const
+{
+    auto serializer = createConfigurationSerializer(getSettingsDirPath() + filename,
+                                                    mode,
+                                                    mPersistenceMode == PersistenceMode::kJournal);
+
+    if (serializer)
+    {
+        serializer->setSyncPolicy(mSyncPolicy);
+    }
+
+    return serializer;
+}
+
+QVector<int> Manager::getUncachedReaders(const QStringList& filenames,
+                                         QVector<std::shared_ptr<Serializer>>& serializers,
+                                         QVector<SerializerCache::Stamp>& stamps) const
+{
+    QVector<int> indexes;
+    const auto dirPath = getSettingsDirPath();
+
+    serializers.clear();
+    serializers.resize(filenames.size());
+    stamps.clear();
+    stamps.resize(filenames.size());
+
+    // Files are stamped before parsing, so a change during the parse leaves the entry stale.
+    for (int i = 0; i < filenames.size(); ++i)
+    {
+        stamps[i] = SerializerCache::getStamp(dirPath + filenames.at(i));
+        serializers[i] = mSerializerCache.getReader(dirPath + filenames.at(i));
+
+        if (!serializers.at(i))
+        {
+            indexes.append(i);
+        }
+    }
+
+    return indexes;
+}
+
+void Manager::applyLoaded(const QString& filename,
+                          const std::shared_ptr<Serializer>& serializer,
+                          const SerializerCache::Stamp& stamp)
+{
+    auto setting = mConfigurations.value(filename);
+
+    if (serializer && setting)
+    {
+        mSerializerCache.setReader(getSettingsDirPath() + filename, serializer, stamp);
+        setting->load(serializer);
+        setting->clearDirty();
+        mIsSnapshotRebuildNeeded = true;
+    }
+}
+
+void Manager::onLoadResultReady(int index)
+{
+    if (mLoadWatcher.isCanceled())
+    {
+        return;
+    }
+
+    auto fileIndex = mLoadWatcher.resultAt(index);
+    auto serializer = mLoadedSerializers.at(fileIndex);
+    mLoadedSerializers[fileIndex].reset();
+
+    applyLoaded(mLoadingFiles.at(fileIndex), serializer, mLoadedStamps.at(fileIndex));
+
+    emit signalLoadProgress(++mLoadedCount, mLoadingFiles.size());
+}
+
+void Manager::onLoadFinished()
+{
+    mLoadedSerializers.clear();
+    mLoadedStamps.clear();
+    mLoadingFiles.clear();
+
+    if (mLoadWatcher.isCanceled())
+    {
+        emit signalLoadCanceled();
+    }
+    else
+    {
+        emit signalDataLoaded();
+    }
+}
+
+std::shared_ptr<Serializer> Manager::prepareSave(const QString& filename)
+{
+    auto setting = mConfigurations[filename];
+    const auto path = getSettingsDirPath() + filename;
+
+    // A journal left behind in snapshot mode has already been replayed, so it is folded in
+    // with a full save before a partial one changes the base file under it.
+    bool isFullSave = mUnsavedFiles.contains(filename) ||
+                      !QFileInfo::exists(path) ||
+                      (mPersistenceMode == PersistenceMode::kSnapshot &&
+                       QFileInfo::exists(SerializerJournal::getJournalPath(path)));
+
+    if (!isFullSave && !setting->isDirty())
+    {
+        return {};
+    }
+
+    // Cached readers may hold the file open, which blocks its atomic replace on Windows.
+    mSerializerCache.invalidate(path);
+
+    auto serializer = mSerializerCache.getWriter(path);
+
+    if (serializer)
+    {
+        serializer->setSyncPolicy(mSyncPolicy);
+        serializer->setCompressionLevel(mCompressionLevels.value(filename));
+
+        if (auto journal = qobject_cast<SerializerJournal*>(serializer.get()))
+        {
+            journal->setCompacting(isFullSave ||
+                                   journal->getJournalSize() >= mJournalCompactionSize);
+        }
+
+        setting->save(serializer.get(),
+                      !isFullSave && serializer->isPartialWriteSupported());
+        setting->clearDirty();
+        mUnsavedFiles.remove(filename);
+    }
+
+    return serializer;
+}
+
+void Manager::saveConfigurationsAsync()
+{
+    if (mSaveWatcher.isRunning())
+    {
+        mIsSavePending = true;
+        return;
+    }
+
+    QMap<QString, Serializer*> serializers;
+
+    for (auto& filename : mConfigurations.keys())
+    {
+        if (auto serializer = prepareSave(filename))
+        {
+            mSavingSerializers.insert(filename, serializer);
+            serializers.insert(filename, serializer.get());
+        }
+    }
+
+    if (mSavingSerializers.isEmpty())
+    {
+        emit signalDataSaved(true);
+        return;
+    }
+
+    mSaveWatcher.setFuture(QtConcurrent::run([serializers]() {
+        QStringList failedFiles;
+
+        for (auto it = serializers.cbegin(); it != serializers.cend(); ++it)
+        {
+            if (!it.value()->sync())
+            {
+                failedFiles.append(it.key());
+            }
+        }
+
+        return failedFiles;
+    }));
+}
+
+void Manager::onSaveFinished()
+{
+    const auto failedFiles = mSaveWatcher.result();
+
+    for (auto it = mSavingSerializers.cbegin(); it != mSavingSerializers.cend(); ++it)
+    {
+        if (failedFiles.contains(it.key()))
+        {
+            mUnsavedFiles.insert(it.key());
+        }
+        else
+        {
+            onFileSaved(it.key());
+        }
+    }
+
+    mSavingSerializers.clear();
+
+    emit signalDataSaved(failedFiles.isEmpty());
+
+    if (mIsSavePending)
+    {
+        mIsSavePending = false;
+        saveConfigurationsAsync();
+    }
+}
+
+void Manager::onFileSaved(const QString& filename)
+{
+    mSerializerCache.invalidate(getSettingsDirPath() + filename);
+
+    if (mPersistenceMode == PersistenceMode::kSnapshot)
+    {
+        QFile::remove(SerializerJournal::getJournalPath(getSettingsDirPath() + filename));
+    }
+
+    if (!mIsHotReloadEnabled)
+    {
+        return;
+    }
+
+    QFileInfo info(getSettingsDirPath() + filename);
+    mSavedFileStates.insert(filename, {info.lastModified(), info.size()});
+
+    updateWatchedFiles();
+}
+
+void Manager::updateWatchedFiles()
+{
+    if (!mIsHotReloadEnabled)
+    {
+        if (!mFileWatcher.files().isEmpty())
+        {
+            mFileWatcher.removePaths(mFileWatcher.files());
+        }
+
+        if (!mFileWatcher.directories().isEmpty())
+        {
+            mFileWatcher.removePaths(mFileWatcher.directories());
+        }
+
+        mReloadTimer.stop();
+        mChangedFiles.clear();
+        return;
+    }
+
+    const auto dirPath = getSettingsDirPath();
+    const auto watchedFiles = mFileWatcher.files();
+    const auto watchedDirs = mFileWatcher.directories();
+
+    for (const auto& filename : mConfigurations.keys())
+    {
+        const auto path = dirPath + filename;
+        const auto dir = QFileInfo(path).absolutePath();
+
+        if (QFileInfo::exists(path) && !watchedFiles.contains(path))
+        {
+            mFileWatcher.addPath(path);
+        }
+
+        if (!watchedDirs.contains(dir))
+        {
+            mFileWatcher.addPath(dir);
+        }
+    }
+}
+
+void Manager::onWatchedPathChanged()
+{
+    const auto dirPath = getSettingsDirPath();
+    const auto watchedFiles = mFileWatcher.files();
+
+    for (const auto& filename : mConfigurations.keys())
+    {
+        const auto path = dirPath + filename;
+
+        if (!watchedFiles.contains(path) && QFileInfo::exists(path))
+        {
+            onFileChanged(path);
+        }
+    }
+}
+
+void Manager::onFileChanged(const QString& path)
+{
+    const auto dirPath = getSettingsDirPath();
+
+    if (path.startsWith(dirPath))
+    {
+        mChangedFiles.insert(path.mid(dirPath.size()));
+        mReloadTimer.start();
+    }
+}
+
+void Manager::reloadChangedFiles()
+{
+    if (isLoading())
+    {
+        mReloadTimer.start();
+        return;
+    }
+
+    const auto changedFiles = mChangedFiles;
+    mChangedFiles.clear();
+
+    updateWatchedFiles();
+
+    for (const auto& filename : changedFiles)
+    {
+        auto setting = mConfigurations.value(filename);
+        QFileInfo info(getSettingsDirPath() + filename);
+
+        if (!setting || !info.exists())
+        {
+            continue;
+        }
+
+        auto savedState = mSavedFileStates.constFind(filename);
+        if (savedState != mSavedFileStates.constEnd() &&
+            savedState->first == info.lastModified() &&
+            savedState->second == info.size())
+        {
+            continue;
+        }
+
+        const auto stamp = SerializerCache::getStamp(info.filePath());
+        std::shared_ptr<Serializer> serializer(
+            createSerializer(filename, Serializer::Mode::kRead));
+
+        if (serializer)
+        {
+            mSerializerCache.setReader(info.filePath(), serializer, stamp);
+            setting->reload(serializer);
+            emit signalConfigurationReloaded(filename);
+        }
+    }
+}
+
+void Manager::registerSetting(Setting* setting)
+{
+    mManagedSettings.insert(setting);
+    markSnapshotChanged(setting);
+
+    // Settings without a key, such as caption-only items, are not addressable by path.
+    if (setting->getKey().isEmpty())
+    {
+        return;
+    }
+
+    auto& indexed = mSettingIndex[setting->getKeyPath().key];
+
+    if (!indexed)
+    {
+        indexed = setting;
+    }
+    else if (indexed != setting)
+    {
+        qWarning("Duplicate setting path %s.", qPrintable(setting->getKeyPath().key));
+    }
+}
+
+void Manager::unregisterSetting(Setting* setting)
+{
+    mManagedSettings.remove(setting);
+    mSnapshotChanges.remove(setting);
+
+    if (mIsSnapshotEnabled && mSnapshotValues.remove(setting->getKeyPath().key) > 0)
+    {
+        scheduleSnapshot();
+    }
+
+    auto it = mSettingIndex.find(setting->getKeyPath().key);
+
+    if (it != mSettingIndex.end() && it.value() == setting)
+    {
+        mSettingIndex.erase(it);
+    }
+}
+
+void Manager::addTransactionChange(Setting* setting)
+{
+    if (!mChangedSettings.contains(setting))
+    {
+        mChangedSettings.insert(setting);
+        mTransactionChanges.append(setting);
+    }
+}
+
+void Manager::discardTransactionChange(Setting* setting)
+{
+    if (mChangedSettings.remove(setting))
+    {
+        mTransactionChanges.removeOne(setting);
+    }
+}
+
+void Manager::scheduleSnapshot()
+{
+    if (mIsSnapshotEnabled && !mSnapshotTimer.isActive())
+    {
+        mSnapshotTimer.start(0);
+    }
+}
+
+void Manager::markSnapshotChanged(Setting* setting)
+{
+    if (mIsSnapshotEnabled && !mIsSnapshotRebuildNeeded)
+    {
+        mSnapshotChanges.insert(setting);
+        scheduleSnapshot();
+    }
+}
+
+void Manager::updateSnapshotValue(Setting* setting)
+{
+    // Lazy settings that haven't been loaded yet are left out rather than loaded here.
+    if (setting->getKey().isEmpty() || setting->mPendingSerializer)
+    {
+        return;
+    }
+
+    auto value = setting->getValue();
+
+    if (value.isValid())
+    {
+        mSnapshotValues.insert(setting->getKeyPath().key, value);
+    }
+    else
+    {
+        mSnapshotValues.remove(setting->getKeyPath().key);
+    }
+}
+
+void Manager::publishSnapshot()
+{
+    mSnapshotTimer.stop();
+
+    if (mIsSnapshotRebuildNeeded)
+    {
+        mSnapshotValues.clear();
+        mSnapshotValues.reserve(mManagedSettings.size());
+
+        for (auto& setting : qAsConst(mManagedSettings))
+        {
+            updateSnapshotValue(setting);
+        }
+
+        mIsSnapshotRebuildNeeded = false;
+    }
+    else
+    {
+        for (auto& setting : qAsConst(mSnapshotChanges))
+        {
+            updateSnapshotValue(setting);
+        }
+    }
+
+    mSnapshotChanges.clear();
+
+    // The published hash shares its nodes with mSnapshotValues until the next change detaches it.
+    auto values = mSnapshotValues;
+
+    if (!mSnapshotPublisher.publish(std::move(values)))
+    {
+        mSnapshotTimer.start(10);
+        return;
+    }
+
+    emit signalSnapshotPublished(mSnapshotPublisher.getVersion());
+}
+
+Manager::Transaction::Transaction(Manager* manager)
+    : mManager(manager)
+{
+    mManager->beginTransaction();
+}
+
+Manager::Transaction::~Transaction()
+{
+    mManager->commitTransaction();
 }
@@ -0,0 +1,68 @@
+#include "custom_setting_schema.h"
+#include <QSet>
+
+using namespace custom_setting;
+
+namespace
+{
+
+const int kMinPurgeSize = 64;
+
+struct StringPool
+{
+    QMutex mutex;
+    QSet<QString> strings;
+    int purgeSize{kMinPurgeSize};
+};
+
+StringPool& getStringPool()
+{
+    static auto pool = new StringPool;
+    return *pool;
+}
+
+// Strings only the pool still refers to are dropped once the pool has doubled.
+void purgeUnused(StringPool& pool)
+{
+    for (auto it = pool.strings.begin(); it != pool.strings.end();)
+    {
+        it = it->isDetached() ? pool.strings.erase(it) : std::next(it);
+    }
+
+    pool.purgeSize = qMax(kMinPurgeSize, pool.strings.size() * 2);
+}
+
+} // namespace
+
+QString SettingSchema::internString(const QString& text)
+{
+    if (text.isEmpty())
+    {
+        return {};
+    }
+
+    auto& pool = getStringPool();
+    QMutexLocker locker(&pool.mutex);
+
+    auto it = pool.strings.constFind(text);
+
+    if (it != pool.strings.constEnd())
+    {
+        return *it;
+    }
+
+    if (pool.strings.size() >= pool.purgeSize)
+    {
+        purgeUnused(pool);
+    }
+
+    return *pool.strings.insert(text);
+}
+
+int SettingSchema::getStringCount()
+{
+    auto& pool = getStringPool();
+    QMutexLocker locker(&pool.mutex);
+
+    return pool.strings.size();
+}
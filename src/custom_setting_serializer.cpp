@@ -1,51 +1,372 @@
 #include "custom_setting_serializer.h"
-#include <QJsonDocument>
+#include "custom_setting_json_writer.h"
+#include "custom_setting_atomic_file.h"
+#include "custom_setting_compression.h"
+#include <QDataStream>
+#include <QtEndian>
+#include <QReadWriteLock>
+#include <QCborValue>
+#include <QJsonArray>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <algorithm>
+#include <cstring>
+#include <limits>
 
 using namespace custom_setting;
 
+namespace
+{
+
+const char kBinaryMagic[] = {'C', 'S', 'B', '1'};
+const quint32 kBinaryVersion = 1;
+const qint64 kBinaryHeaderSize = 16;
+const qint64 kBinaryEntrySize = 20;
+const QDataStream::Version kBinaryStreamVersion = QDataStream::Qt_5_12;
+const QByteArray kCborSignature("\xd9\xd9\xf7");
+const QByteArray kSqliteSignature("SQLite format 3\0", 16);
+const QString kSqliteDriver("QSQLITE");
+const qint64 kSniffSize = 64;
+
+struct BinaryEntry
+{
+    quint32 hash;
+    QString key;
+    quint32 valueOffset;
+    quint32 valueLength;
+};
+
+quint32 binaryKeyHash(const QString& key)
+{
+    quint32 hash = 2166136261u;
+
+    for (auto ch : key)
+    {
+        hash ^= ch.unicode();
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+quint32 readUInt32(const uchar* data)
+{
+    return qFromLittleEndian<quint32>(data);
+}
+
+void appendUInt32(QByteArray& buffer, quint32 value)
+{
+    uchar bytes[sizeof(quint32)];
+    qToLittleEndian(value, bytes);
+    buffer.append(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+template <typename T>
+Serializer* createSerializer(const QString& filename,
+                             Serializer::Mode mode,
+                             QObject* parent)
+{
+    return new T(filename, mode, parent);
+}
+
+struct SerializerFormat
+{
+    Serializer::Factory factory;
+    Serializer::Sniffer sniffer;
+};
+
+struct SerializerRegistry
+{
+    QReadWriteLock lock;
+    QHash<QString, SerializerFormat> formats;
+    QStringList order;
+};
+
+void insertFormat(SerializerRegistry& registry,
+                  const QString& suffix,
+                  const Serializer::Factory& factory,
+                  const Serializer::Sniffer& sniffer)
+{
+    if (!registry.formats.contains(suffix))
+    {
+        registry.order.append(suffix);
+    }
+
+    registry.formats.insert(suffix, {factory, sniffer});
+}
+
+SerializerRegistry& getRegistry()
+{
+    static SerializerRegistry registry;
+    static const bool isInitialized = [] {
+        insertFormat(registry, "ini", createSerializer<SerializerIni>, {});
+        insertFormat(registry, "json", createSerializer<SerializerJson>,
+                     [](const QByteArray& header) {
+                         return header.trimmed().startsWith('{');
+                     });
+        insertFormat(registry, "bin", createSerializer<SerializerBinary>,
+                     [](const QByteArray& header) {
+                         return header.startsWith(QByteArray(kBinaryMagic,
+                                                             sizeof(kBinaryMagic)));
+                     });
+        insertFormat(registry, "cbor", createSerializer<SerializerCbor>,
+                     [](const QByteArray& header) {
+                         return header.startsWith(kCborSignature);
+                     });
+        insertFormat(registry, "sqlite", createSerializer<SerializerSqlite>,
+                     [](const QByteArray& header) {
+                         return header.startsWith(kSqliteSignature);
+                     });
+        insertFormat(registry, "db", createSerializer<SerializerSqlite>, {});
+        return true;
+    }();
+
+    Q_UNUSED(isInitialized)
+    return registry;
+}
+
+Serializer::Factory sniffFormat(const QString& filename)
+{
+    QFile file(filename);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return {};
+    }
+
+    auto header = Compression::read(&file, kSniffSize);
+    auto& registry = getRegistry();
+    QReadLocker locker(&registry.lock);
+
+    for (const auto& suffix : registry.order)
+    {
+        const auto& format = registry.formats[suffix];
+
+        if (format.sniffer && format.sniffer(header))
+        {
+            return format.factory;
+        }
+    }
+
+    return {};
+}
+
+} // namespace
+
+KeyPath KeyPath::fromKey(const QString& key)
+{
+    int n = key.indexOf('/');
+    return {key, key.mid(n + 1).split('/')};
+}
+
+ValueTree::ValueTree()
+{
+    clear();
+}
+
+void ValueTree::setValue(const KeyPath& path, const QVariant& value)
+{
+    auto it = mPathIndex.constFind(path.key);
+    int index = 0;
+
+    if (it != mPathIndex.constEnd())
+    {
+        index = it.value();
+    }
+    else
+    {
+        for (const auto& segment : path.segments)
+        {
+            auto child = mNodes.at(index).children.constFind(segment);
+
+            if (child != mNodes.at(index).children.constEnd())
+            {
+                index = child.value();
+                continue;
+            }
+
+            Node node;
+            node.key = segment;
+
+            mNodes.append(node);
+            mNodes[index].children.insert(segment, mNodes.size() - 1);
+            index = mNodes.size() - 1;
+        }
+
+        mPathIndex.insert(path.key, index);
+    }
+
+    mNodes[index].value = value;
+}
+
+const ValueTree::Node& ValueTree::getNode(int index) const
+{
+    return mNodes.at(index);
+}
+
+const ValueTree::Node& ValueTree::getRoot() const
+{
+    return mNodes.at(0);
+}
+
+bool ValueTree::isEmpty() const
+{
+    return mNodes.size() == 1;
+}
+
+void ValueTree::clear()
+{
+    mNodes.clear();
+    mPathIndex.clear();
+    mNodes.append(Node());
+}
+
 Serializer::Serializer(const QString& filename, Mode mode, QObject* parent) :
     QObject(parent),
     mFilename(filename),
     mMode(mode)
 {}
 
+bool Serializer::isPartialWriteSupported() const
+{
+    return false;
+}
+
+void Serializer::setValue(const QString& key,
+                          const QVariant& value,
+                          bool asPlainValue)
+{
+    setValue(KeyPath::fromKey(key), value, asPlainValue);
+}
+
+QVariant Serializer::getValue(const QString& key,
+                              const QVariant& defaultValue,
+                              bool asPlainValue)
+{
+    return getValue(KeyPath::fromKey(key), defaultValue, asPlainValue);
+}
+
+bool Serializer::readValue(const KeyPath& path, ValueVisitor& visitor)
+{
+    auto value = getValue(path, QVariant(), true);
+
+    if (!value.isValid())
+    {
+        return false;
+    }
+
+    visitor.visit(std::move(value));
+    return true;
+}
+
+void Serializer::reset()
+{
+}
+
+void Serializer::releaseFile()
+{
+}
+
+void Serializer::setSyncPolicy(SyncPolicy policy)
+{
+    mSyncPolicy = policy;
+}
+
+void Serializer::setCompressionLevel(int level)
+{
+    mCompressionLevel = level;
+}
+
+int Serializer::getCompressionLevel() const
+{
+    return mCompressionLevel;
+}
+
+const QString& Serializer::getFilename() const
+{
+    return mFilename;
+}
+
 Serializer* Serializer::create(const QString& filename, Mode mode, QObject* parent)
 {
     QFileInfo finfo(filename);
-    auto ext = finfo.suffix();
+    auto ext = finfo.suffix().toLower();
+    auto& registry = getRegistry();
+    Factory factory;
 
-    if (ext == "ini")
     {
-        return new SerializerIni(filename, mode, parent);
+        QReadLocker locker(&registry.lock);
+        auto it = registry.formats.constFind(ext);
+
+        if (it != registry.formats.constEnd())
+        {
+            factory = it->factory;
+        }
     }
-    else if (ext == "json")
+
+    if (!factory)
     {
-        return new SerializerJson(filename, mode, parent);
+        factory = sniffFormat(filename);
     }
 
-    return nullptr;
+    return factory ? factory(filename, mode, parent) : nullptr;
+}
+
+void Serializer::registerFormat(const QString& suffix,
+                                const Factory& factory,
+                                const Sniffer& sniffer)
+{
+    auto& registry = getRegistry();
+    QWriteLocker locker(&registry.lock);
+
+    insertFormat(registry, suffix.toLower(), factory, sniffer);
 }
 
 SerializerIni::SerializerIni(const QString& filename, Mode mode, QObject* parent)
     : Serializer(filename, mode, parent)
-    , mSettings(new QSettings(filename, QSettings::IniFormat, parent))
-{}
+{
+    if (mMode == Serializer::Mode::kRead)
+    {
+        mSettings = new QSettings(filename, QSettings::IniFormat, this);
+    }
+}
 
-void SerializerIni::setValue(const QString& key, const QVariant& value, bool)
+void SerializerIni::setValue(const KeyPath& path, const QVariant& value, bool)
 {
-    mSettings->setValue(key, value);
+    mValues.insert(path.key, value);
 }
 
-QVariant SerializerIni::getValue(const QString& key,
+QVariant SerializerIni::getValue(const KeyPath& path,
                                  const QVariant& defaultValue,
                                  bool)
 {
-    return mSettings->value(key, defaultValue);
+    return mSettings ? mSettings->value(path.key, defaultValue)
+                     : mValues.value(path.key, defaultValue);
 }
 
-void SerializerIni::sync()
+// QSettings posts update events to its own thread, so it is created here,
+// on the thread that writes, rather than next to the GUI thread's setValue calls.
+bool SerializerIni::sync()
 {
-    mSettings->sync();
+    QSettings settings(mFilename, QSettings::IniFormat);
+
+    for (auto it = mValues.cbegin(); it != mValues.cend(); ++it)
+    {
+        settings.setValue(it.key(), it.value());
+    }
+
+    settings.sync();
+    return settings.status() == QSettings::NoError;
+}
+
+bool SerializerIni::isPartialWriteSupported() const
+{
+    return true;
+}
+
+void SerializerIni::reset()
+{
+    mValues.clear();
 }
 
 SerializerJson::SerializerJson(const QString& filename, Mode mode, QObject* parent)
@@ -61,99 +382,745 @@ SerializerJson::SerializerJson(const QString& filename, Mode mode, QObject* pare
            return;
         }
 
-        QJsonDocument doc(QJsonDocument::fromJson(file.readAll()));
-        mJsonObject = doc.object();
+        QJsonDocument doc(QJsonDocument::fromJson(Compression::read(&file)));
+        auto root = doc.object();
+
+        buildIndex(root, QStringLiteral("/"));
+
+        for (auto it = root.constBegin(); it != root.constEnd(); ++it)
+        {
+            if (it.key().contains('/'))
+            {
+                mIndex.insert('/' + it.key(), it.value());
+            }
+        }
     }
 }
 
-void SerializerJson::setValue(const QString& key,
-                              const QVariant& value,
-                              bool asPlainValue)
+void SerializerJson::setValue(const KeyPath& path, const QVariant& value, bool)
+{
+    mTree.setValue(path, value);
+}
+
+QVariant SerializerJson::getValue(const KeyPath& path,
+                                  const QVariant& defaultValue,
+                                  bool)
 {
-    int n = key.indexOf("/");
-    QString lastKey = key.right(key.length() - (n + 1));
+    auto it = mIndex.constFind(path.key);
+
+    return it != mIndex.constEnd() ? it->toVariant()
+                                   : defaultValue;
+}
 
-    if (asPlainValue)
+bool SerializerJson::readValue(const KeyPath& path, ValueVisitor& visitor)
+{
+    auto it = mIndex.constFind(path.key);
+
+    if (it == mIndex.constEnd())
     {
-        mJsonObject[lastKey] = value.toJsonValue();
+        return false;
     }
 
-    write(mJsonObject, lastKey, value);
+    switch (it->type())
+    {
+    case QJsonValue::Bool:
+        visitor.visit(it->toBool());
+        break;
+    case QJsonValue::Double:
+        visitor.visit(it->toDouble());
+        break;
+    case QJsonValue::String:
+        visitor.visit(it->toString());
+        break;
+    case QJsonValue::Array:
+    {
+        const auto array = it->toArray();
+        QStringList list;
+        list.reserve(array.size());
+
+        for (const auto& item : array)
+        {
+            if (!item.isString())
+            {
+                visitor.visit(it->toVariant());
+                return true;
+            }
+
+            list.append(item.toString());
+        }
+
+        visitor.visit(std::move(list));
+        break;
+    }
+    case QJsonValue::Null:
+    case QJsonValue::Undefined:
+        return false;
+    default:
+        visitor.visit(it->toVariant());
+        break;
+    }
+
+    return true;
 }
 
-QVariant SerializerJson::getValue(const QString& key,
-                                  const QVariant& defaultValue,
-                                  bool asPlainValue)
+bool SerializerJson::sync()
 {
-    int n = key.indexOf("/");
-    QString lastKey = key.right(key.length() - (n + 1));
+    AtomicFile file(mFilename, mSyncPolicy);
+    file.setCompressionLevel(mCompressionLevel);
+
+    if (!file.open())
+    {
+        qWarning("Couldn't open file.");
+        return false;
+    }
+
+    JsonStreamWriter writer(file.getDevice(), mFormat);
 
-    if (asPlainValue)
+    if (!writer.write(mTree) || !file.commit())
     {
-        return mJsonObject.contains(lastKey) ? mJsonObject[lastKey].toVariant()
-                                             : defaultValue;
+        qWarning("Couldn't write file.");
+        return false;
     }
 
-    return read(mJsonObject, lastKey, defaultValue);
+    return true;
 }
 
-void SerializerJson::sync()
+void SerializerJson::reset()
 {
-    QFile file(mFilename);
+    mTree.clear();
+}
 
-    if (!file.open(QIODevice::WriteOnly))
+void SerializerJson::setFormat(QJsonDocument::JsonFormat format)
+{
+    mFormat = format;
+}
+
+void SerializerJson::buildIndex(const QJsonObject& obj, const QString& prefix)
+{
+    for (auto it = obj.constBegin(); it != obj.constEnd(); ++it)
+    {
+        if (it.key() == QLatin1String(ValueTree::kValueKey))
+        {
+            continue;
+        }
+
+        auto key = prefix + it.key();
+
+        if (it.value().isObject())
+        {
+            auto child = it.value().toObject();
+            buildIndex(child, key + '/');
+
+            auto value = child.constFind(QLatin1String(ValueTree::kValueKey));
+
+            if (value != child.constEnd())
+            {
+                mIndex.insert(key, value.value());
+                continue;
+            }
+        }
+
+        mIndex.insert(key, it.value());
+    }
+}
+
+SerializerBinary::SerializerBinary(const QString& filename, Mode mode, QObject* parent)
+    : Serializer(filename, mode, parent)
+    , mFile(filename)
+{
+    if (mMode != Serializer::Mode::kRead)
+    {
+        return;
+    }
+
+    if (!mFile.open(QIODevice::ReadOnly))
     {
         qWarning("Couldn't open file.");
         return;
     }
 
-    QJsonDocument doc(mJsonObject);
-    file.write(doc.toJson());
+    const uchar* data = nullptr;
+
+    if (Compression::isCompressed(&mFile))
+    {
+        mBuffer = Compression::read(&mFile);
+        mFile.close();
+        mSize = mBuffer.size();
+        data = reinterpret_cast<const uchar*>(mBuffer.constData());
+    }
+    else
+    {
+        mSize = mFile.size();
+    }
+
+    if (mSize < kBinaryHeaderSize)
+    {
+        qWarning("Invalid binary settings file.");
+        return;
+    }
+
+    if (!data)
+    {
+        data = mFile.map(0, mSize);
+    }
+
+    if (!data ||
+        memcmp(data, kBinaryMagic, sizeof(kBinaryMagic)) != 0 ||
+        readUInt32(data + 4) != kBinaryVersion)
+    {
+        qWarning("Invalid binary settings file.");
+        return;
+    }
+
+    auto count = readUInt32(data + 8);
+
+    if (kBinaryHeaderSize + count * kBinaryEntrySize > mSize)
+    {
+        qWarning("Invalid binary settings file.");
+        return;
+    }
+
+    mData = data;
+    mCount = count;
 }
 
-void SerializerJson::write(QJsonObject& obj,
-                           const QString& key,
-                           const QVariant& value)
+void SerializerBinary::setValue(const KeyPath& path, const QVariant& value, bool)
 {
-    int n = key.indexOf("/");
+    mValues[path.key] = value;
+}
+
+QVariant SerializerBinary::getValue(const KeyPath& path,
+                                    const QVariant& defaultValue,
+                                    bool)
+{
+    auto entry = findEntry(path.key);
 
-    if (n == -1)
+    if (!entry)
     {
-        obj[key] = QJsonValue::fromVariant(value);
+        return defaultValue;
     }
-    else
+
+    auto offset = readUInt32(entry + 12);
+    auto length = readUInt32(entry + 16);
+
+    if (qint64(offset) + length > mSize)
+    {
+        return defaultValue;
+    }
+
+    auto raw = QByteArray::fromRawData(reinterpret_cast<const char*>(mData + offset),
+                                       int(length));
+    QDataStream stream(raw);
+    stream.setVersion(kBinaryStreamVersion);
+
+    QVariant value;
+    stream >> value;
+
+    return stream.status() == QDataStream::Ok ? value : defaultValue;
+}
+
+bool SerializerBinary::sync()
+{
+    QVector<BinaryEntry> entries;
+    QByteArray values;
+    entries.reserve(mValues.size());
+
+    for (auto it = mValues.cbegin(); it != mValues.cend(); ++it)
+    {
+        QByteArray value;
+        QDataStream stream(&value, QIODevice::WriteOnly);
+        stream.setVersion(kBinaryStreamVersion);
+        stream << it.value();
+
+        entries.append({binaryKeyHash(it.key()),
+                        it.key(),
+                        quint32(values.size()),
+                        quint32(value.size())});
+        values.append(value);
+    }
+
+    std::sort(entries.begin(), entries.end(),
+              [](const BinaryEntry& lhs, const BinaryEntry& rhs) {
+                  return lhs.hash != rhs.hash ? lhs.hash < rhs.hash
+                                              : lhs.key < rhs.key;
+              });
+
+    QByteArray header;
+    QByteArray keys;
+    qint64 keysOffset = kBinaryHeaderSize + entries.size() * kBinaryEntrySize;
+    qint64 keysSize = 0;
+
+    for (const auto& entry : entries)
     {
-        QJsonObject subObj;
-        QString lastKey = key.right(key.length() - (n + 1));
-        QString curKey = key.left(n);
+        keysSize += entry.key.size() * 2;
+    }
 
-        if (!obj[curKey].isNull())
+    if (keysSize > std::numeric_limits<int>::max())
+    {
+        qWarning("Binary settings file is too large.");
+        return false;
+    }
+
+    keys.reserve(int(keysSize));
+
+    for (const auto& entry : entries)
+    {
+        for (auto ch : entry.key)
         {
-            subObj = obj[curKey].toObject();
+            uchar bytes[sizeof(quint16)];
+            qToLittleEndian(ch.unicode(), bytes);
+            keys.append(reinterpret_cast<const char*>(bytes), sizeof(bytes));
         }
+    }
+
+    qint64 valuesOffset = keysOffset + keys.size();
 
-        write(subObj, lastKey, value);
-        obj[curKey] = subObj;
+    if (valuesOffset + values.size() > std::numeric_limits<quint32>::max())
+    {
+        qWarning("Binary settings file is too large.");
+        return false;
+    }
+
+    header.append(kBinaryMagic, sizeof(kBinaryMagic));
+    appendUInt32(header, kBinaryVersion);
+    appendUInt32(header, quint32(entries.size()));
+    appendUInt32(header, 0);
+
+    quint32 keyOffset = quint32(keysOffset);
+    for (const auto& entry : entries)
+    {
+        appendUInt32(header, entry.hash);
+        appendUInt32(header, keyOffset);
+        appendUInt32(header, quint32(entry.key.size()));
+        appendUInt32(header, quint32(valuesOffset) + entry.valueOffset);
+        appendUInt32(header, entry.valueLength);
+        keyOffset += quint32(entry.key.size() * 2);
     }
+
+    AtomicFile file(mFilename, mSyncPolicy);
+    file.setCompressionLevel(mCompressionLevel);
+
+    if (!file.open())
+    {
+        qWarning("Couldn't open file.");
+        return false;
+    }
+
+    auto device = file.getDevice();
+
+    if (device->write(header) != header.size() ||
+        device->write(keys) != keys.size() ||
+        device->write(values) != values.size() ||
+        !file.commit())
+    {
+        qWarning("Couldn't write file.");
+        return false;
+    }
+
+    return true;
 }
 
-QVariant SerializerJson::read(QJsonObject obj,
-                              const QString& key,
-                              const QVariant& defaultValue)
+void SerializerBinary::reset()
 {
-    int n = key.indexOf("/");
+    mValues.clear();
+}
 
-    if (n == -1)
+void SerializerBinary::releaseFile()
+{
+    if (!mFile.isOpen())
     {
-        return obj.contains(key) ? obj[key].toVariant()
-                                 : defaultValue;
+        return;
     }
-    else
+
+    // Readers still held elsewhere keep working from a private copy of the mapping.
+    if (mData)
+    {
+        mBuffer = QByteArray(reinterpret_cast<const char*>(mData), int(mSize));
+        mData = reinterpret_cast<const uchar*>(mBuffer.constData());
+    }
+
+    mFile.close();
+}
+
+const uchar* SerializerBinary::findEntry(const QString& key) const
+{
+    if (!mData)
+    {
+        return nullptr;
+    }
+
+    auto hash = binaryKeyHash(key);
+    const uchar* table = mData + kBinaryHeaderSize;
+    quint32 first = 0;
+    quint32 last = mCount;
+
+    while (first < last)
+    {
+        auto middle = first + (last - first) / 2;
+
+        if (readUInt32(table + middle * kBinaryEntrySize) < hash)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+
+    for (; first < mCount; ++first)
+    {
+        auto entry = table + first * kBinaryEntrySize;
+
+        if (readUInt32(entry) != hash)
+        {
+            break;
+        }
+
+        if (isKeyEqual(entry, key))
+        {
+            return entry;
+        }
+    }
+
+    return nullptr;
+}
+
+bool SerializerBinary::isKeyEqual(const uchar* entry, const QString& key) const
+{
+    auto offset = readUInt32(entry + 4);
+    auto length = readUInt32(entry + 8);
+
+    if (length != quint32(key.size()) || qint64(offset) + qint64(length) * 2 > mSize)
+    {
+        return false;
+    }
+
+    auto chars = mData + offset;
+    for (int i = 0; i < key.size(); ++i)
+    {
+        if (qFromLittleEndian<quint16>(chars + i * 2) != key.at(i).unicode())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+SerializerCbor::SerializerCbor(const QString& filename, Mode mode, QObject* parent)
+    : Serializer(filename, mode, parent)
+{
+    if (mMode != Serializer::Mode::kRead)
+    {
+        return;
+    }
+
+    QFile file(filename);
+
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        qWarning("Couldn't open file.");
+        return;
+    }
+
+    CompressedDevice compressed(&file);
+    QIODevice* device = &file;
+
+    if (Compression::isCompressed(&file))
+    {
+        compressed.open(QIODevice::ReadOnly);
+        device = &compressed;
+    }
+
+    QCborStreamReader reader(device);
+
+    if (reader.isTag() && reader.toTag() == QCborTag(QCborKnownTags::Signature))
+    {
+        reader.next();
+    }
+
+    if (!reader.isMap() || !readMap(reader, QStringLiteral("/")))
+    {
+        qWarning("Invalid CBOR settings file.");
+    }
+}
+
+void SerializerCbor::setValue(const KeyPath& path, const QVariant& value, bool)
+{
+    mTree.setValue(path, value);
+}
+
+QVariant SerializerCbor::getValue(const KeyPath& path,
+                                  const QVariant& defaultValue,
+                                  bool)
+{
+    auto it = mIndex.constFind(path.key);
+
+    return it != mIndex.constEnd() ? it.value()
+                                   : defaultValue;
+}
+
+bool SerializerCbor::sync()
+{
+    AtomicFile file(mFilename, mSyncPolicy);
+    file.setCompressionLevel(mCompressionLevel);
+
+    if (!file.open())
+    {
+        qWarning("Couldn't open file.");
+        return false;
+    }
+
+    QCborStreamWriter writer(file.getDevice());
+    writer.append(QCborKnownTags::Signature);
+    writeNode(writer, mTree.getRoot());
+
+    if (!file.commit())
+    {
+        qWarning("Couldn't write file.");
+        return false;
+    }
+
+    return true;
+}
+
+void SerializerCbor::reset()
+{
+    mTree.clear();
+}
+
+bool SerializerCbor::readMap(QCborStreamReader& reader, const QString& prefix)
+{
+    if (!reader.enterContainer())
     {
-        QJsonObject subObj;
-        QString lastKey = key.right(key.length() - (n + 1));
-        QString curKey = key.left(n);
+        return false;
+    }
+
+    while (reader.lastError() == QCborError::NoError && reader.hasNext())
+    {
+        if (!reader.isString())
+        {
+            reader.next();
+            reader.next();
+            continue;
+        }
+
+        QString key;
+        auto chunk = reader.readString();
+
+        while (chunk.status == QCborStreamReader::Ok)
+        {
+            key += chunk.data;
+            chunk = reader.readString();
+        }
+
+        if (chunk.status == QCborStreamReader::Error)
+        {
+            return false;
+        }
 
-        return read(obj[curKey].toObject(), lastKey, defaultValue);
+        if (reader.isMap())
+        {
+            if (!readMap(reader, prefix + key + '/'))
+            {
+                return false;
+            }
+        }
+        else if (key == QLatin1String(ValueTree::kValueKey) && prefix.size() > 1)
+        {
+            mIndex.insert(prefix.chopped(1), QCborValue::fromCbor(reader).toVariant());
+        }
+        else
+        {
+            mIndex.insert(prefix + key, QCborValue::fromCbor(reader).toVariant());
+        }
     }
+
+    return reader.lastError() == QCborError::NoError && reader.leaveContainer();
+}
+
+void SerializerCbor::writeNode(QCborStreamWriter& writer,
+                               const ValueTree::Node& node) const
+{
+    if (node.children.isEmpty())
+    {
+        QCborValue::fromVariant(node.value).toCbor(writer);
+        return;
+    }
+
+    writer.startMap(quint64(node.children.size() + (node.value.isValid() ? 1 : 0)));
+
+    if (node.value.isValid())
+    {
+        writer.append(QLatin1String(ValueTree::kValueKey));
+        QCborValue::fromVariant(node.value).toCbor(writer);
+    }
+
+    for (auto it = node.children.cbegin(); it != node.children.cend(); ++it)
+    {
+        writer.append(it.key());
+        writeNode(writer, mTree.getNode(it.value()));
+    }
+
+    writer.endMap();
+}
+
+SerializerSqlite::SerializerSqlite(const QString& filename, Mode mode, QObject* parent)
+    : Serializer(filename, mode, parent)
+    , mConnectionName(QString("custom_setting_sqlite_%1").arg(quintptr(this), 0, 16))
+{}
+
+SerializerSqlite::~SerializerSqlite()
+{
+    mSelectQuery.reset();
+
+    if (QSqlDatabase::contains(mConnectionName))
+    {
+        QSqlDatabase::database(mConnectionName, false).close();
+        QSqlDatabase::removeDatabase(mConnectionName);
+    }
+}
+
+void SerializerSqlite::setValue(const KeyPath& path, const QVariant& value, bool)
+{
+    mValues.insert(path.key, value);
+}
+
+QVariant SerializerSqlite::getValue(const KeyPath& path,
+                                    const QVariant& defaultValue,
+                                    bool)
+{
+    if (!prepareSelect())
+    {
+        return defaultValue;
+    }
+
+    mSelectQuery->bindValue(0, path.key);
+
+    if (!mSelectQuery->exec() || !mSelectQuery->next())
+    {
+        mSelectQuery->finish();
+        return defaultValue;
+    }
+
+    auto raw = mSelectQuery->value(0).toByteArray();
+    mSelectQuery->finish();
+
+    QDataStream stream(raw);
+    stream.setVersion(kBinaryStreamVersion);
+
+    QVariant value;
+    stream >> value;
+
+    return stream.status() == QDataStream::Ok ? value : defaultValue;
+}
+
+bool SerializerSqlite::sync()
+{
+    if (mValues.isEmpty())
+    {
+        return true;
+    }
+
+    const auto connectionName = mConnectionName + "_write";
+    bool isOk = writeValues(connectionName);
+    QSqlDatabase::removeDatabase(connectionName);
+
+    return isOk;
+}
+
+bool SerializerSqlite::isPartialWriteSupported() const
+{
+    return true;
+}
+
+void SerializerSqlite::reset()
+{
+    mValues.clear();
+}
+
+bool SerializerSqlite::prepareSelect()
+{
+    if (mSelectQuery)
+    {
+        return true;
+    }
+
+    if (mIsReadFailed || !QFileInfo::exists(mFilename))
+    {
+        mIsReadFailed = true;
+        return false;
+    }
+
+    auto db = QSqlDatabase::addDatabase(kSqliteDriver, mConnectionName);
+    db.setDatabaseName(mFilename);
+    db.setConnectOptions("QSQLITE_OPEN_READONLY");
+
+    if (!db.open())
+    {
+        qWarning("Couldn't open database.");
+        mIsReadFailed = true;
+        return false;
+    }
+
+    mSelectQuery.reset(new QSqlQuery(db));
+    mSelectQuery->setForwardOnly(true);
+
+    if (!mSelectQuery->prepare("SELECT value FROM settings WHERE key = ?"))
+    {
+        mSelectQuery.reset();
+        mIsReadFailed = true;
+        return false;
+    }
+
+    return true;
+}
+
+bool SerializerSqlite::writeValues(const QString& connectionName)
+{
+    auto db = QSqlDatabase::addDatabase(kSqliteDriver, connectionName);
+    db.setDatabaseName(mFilename);
+
+    if (!db.open())
+    {
+        qWarning("Couldn't open database.");
+        return false;
+    }
+
+    QSqlQuery query(db);
+    query.exec(mSyncPolicy == SyncPolicy::kNone ? "PRAGMA synchronous = OFF"
+                                                : "PRAGMA synchronous = FULL");
+
+    if (!query.exec("CREATE TABLE IF NOT EXISTS settings "
+                    "(key TEXT PRIMARY KEY, value BLOB) WITHOUT ROWID") ||
+        !db.transaction())
+    {
+        return false;
+    }
+
+    if (!query.prepare("INSERT OR REPLACE INTO settings (key, value) VALUES (?, ?)"))
+    {
+        db.rollback();
+        return false;
+    }
+
+    for (auto it = mValues.cbegin(); it != mValues.cend(); ++it)
+    {
+        QByteArray value;
+        QDataStream stream(&value, QIODevice::WriteOnly);
+        stream.setVersion(kBinaryStreamVersion);
+        stream << it.value();
+
+        query.bindValue(0, it.key());
+        query.bindValue(1, value);
+
+        if (!query.exec())
+        {
+            db.rollback();
+            return false;
+        }
+    }
+
+    return db.commit();
 }
@@ -0,0 +1,93 @@
+#include "custom_setting_serializer_cache.h"
+
+using namespace custom_setting;
+
+std::shared_ptr<Serializer> SerializerCache::getReader(const QString& filename) const
+{
+    auto it = mEntries.constFind(filename);
+
+    if (it == mEntries.constEnd() || !it->reader)
+    {
+        return {};
+    }
+
+    const auto stamp = getStamp(filename);
+
+    if (stamp.size < 0 ||
+        stamp.lastModified != it->stamp.lastModified ||
+        stamp.size != it->stamp.size)
+    {
+        return {};
+    }
+
+    return it->reader;
+}
+
+void SerializerCache::setReader(const QString& filename,
+                                const std::shared_ptr<Serializer>& serializer,
+                                const Stamp& stamp)
+{
+    auto& entry = mEntries[filename];
+
+    entry.reader = serializer;
+    entry.stamp = stamp;
+}
+
+std::shared_ptr<Serializer> SerializerCache::getWriter(const QString& filename)
+{
+    auto& entry = mEntries[filename];
+
+    if (entry.writer)
+    {
+        entry.writer->reset();
+    }
+    else
+    {
+        entry.writer.reset(mWriterFactory(filename, Serializer::Mode::kWrite, nullptr));
+    }
+
+    return entry.writer;
+}
+
+void SerializerCache::setWriterFactory(const Serializer::Factory& factory)
+{
+    mWriterFactory = factory;
+
+    for (auto& entry : mEntries)
+    {
+        entry.writer.reset();
+    }
+}
+
+void SerializerCache::invalidate(const QString& filename)
+{
+    auto it = mEntries.find(filename);
+
+    if (it != mEntries.end() && it->reader)
+    {
+        // Settings waiting for a lazy load may still hold the reader past this point.
+        if (it->reader.use_count() > 1)
+        {
+            it->reader->releaseFile();
+        }
+
+        it->reader.reset();
+    }
+}
+
+void SerializerCache::remove(const QString& filename)
+{
+    mEntries.remove(filename);
+}
+
+void SerializerCache::clear()
+{
+    mEntries.clear();
+}
+
+SerializerCache::Stamp SerializerCache::getStamp(const QString& filename)
+{
+    QFileInfo info(filename);
+
+    return info.exists() ? Stamp{info.lastModified(), info.size()} : Stamp{};
+}
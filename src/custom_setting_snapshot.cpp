@@ -0,0 +1,141 @@
+#include "custom_setting_snapshot.h"
+#include <limits>
+
+using namespace custom_setting;
+
+namespace
+{
+
+const int kLockedSlot = std::numeric_limits<int>::min() / 2;
+
+} // namespace
+
+Snapshot::Snapshot(quint64 version, QHash<QString, QVariant>&& values)
+    : mVersion(version)
+    , mValues(std::move(values))
+{}
+
+quint64 Snapshot::getVersion() const
+{
+    return mVersion;
+}
+
+QVariant Snapshot::getValue(const QString& path, const QVariant& defaultValue) const
+{
+    return mValues.value(path, defaultValue);
+}
+
+const QHash<QString, QVariant>& Snapshot::getValues() const
+{
+    return mValues;
+}
+
+SnapshotPublisher::Handle::Handle(std::atomic<int>* readers, const Snapshot* snapshot)
+    : mReaders(readers)
+    , mSnapshot(snapshot)
+{}
+
+SnapshotPublisher::Handle::Handle(Handle&& handle)
+    : mReaders(handle.mReaders)
+    , mSnapshot(handle.mSnapshot)
+{
+    handle.mReaders = nullptr;
+    handle.mSnapshot = nullptr;
+}
+
+SnapshotPublisher::Handle& SnapshotPublisher::Handle::operator=(Handle&& handle)
+{
+    if (this != &handle)
+    {
+        release();
+        mReaders = handle.mReaders;
+        mSnapshot = handle.mSnapshot;
+        handle.mReaders = nullptr;
+        handle.mSnapshot = nullptr;
+    }
+
+    return *this;
+}
+
+SnapshotPublisher::Handle::~Handle()
+{
+    release();
+}
+
+const Snapshot* SnapshotPublisher::Handle::operator->() const
+{
+    return mSnapshot;
+}
+
+const Snapshot& SnapshotPublisher::Handle::operator*() const
+{
+    return *mSnapshot;
+}
+
+bool SnapshotPublisher::Handle::isValid() const
+{
+    return mSnapshot != nullptr;
+}
+
+void SnapshotPublisher::Handle::release()
+{
+    if (mReaders)
+    {
+        mReaders->fetch_sub(1, std::memory_order_release);
+        mReaders = nullptr;
+        mSnapshot = nullptr;
+    }
+}
+
+SnapshotPublisher::Handle SnapshotPublisher::acquire() const
+{
+    for (;;)
+    {
+        int index = mCurrent.load(std::memory_order_acquire);
+
+        if (index < 0)
+        {
+            return {};
+        }
+
+        auto& slot = mSlots[index];
+
+        if (slot.readers.fetch_add(1, std::memory_order_acquire) >= 0)
+        {
+            return Handle(&slot.readers, slot.snapshot.get());
+        }
+
+        slot.readers.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+bool SnapshotPublisher::publish(QHash<QString, QVariant>&& values)
+{
+    int current = mCurrent.load(std::memory_order_relaxed);
+
+    for (int i = 0; i < kSlotCount; ++i)
+    {
+        auto& slot = mSlots[i];
+        int readers = 0;
+
+        if (i == current ||
+            !slot.readers.compare_exchange_strong(readers, kLockedSlot,
+                                                  std::memory_order_acquire))
+        {
+            continue;
+        }
+
+        slot.snapshot.reset(new Snapshot(++mVersion, std::move(values)));
+        slot.readers.fetch_sub(kLockedSlot, std::memory_order_release);
+        mCurrent.store(i, std::memory_order_release);
+
+        return true;
+    }
+
+    return false;
+}
+
+quint64 SnapshotPublisher::getVersion() const
+{
+    return mVersion;
+}
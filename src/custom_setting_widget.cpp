@@ -36,30 +36,9 @@ void CustomSettingWidget::bindToSetting(Setting* setting)
         mLayout->insertWidget(0, mWidget);
         applySizeHint();
     }
-    else
+    else if (auto bindMethod = getMethodTable().bindMethods[int(setting->getTypeId())])
     {
-        std::vector<std::function<bool()>> bindMethods = {
-            {[&]{ return bindSetting_if<SettingBool, CustomCheckBox>(setting);}},
-            {[&]{ return bindSetting_if<SettingInt, CustomSpinBox>(setting);}},
-            {[&]{ return bindSetting_if<SettingDouble, CustomDoubleSpinBox>(setting);}},
-            {[&]{ return bindSetting_if<SettingString, CustomLineEdit>(setting);}},
-            {[&]{ return bindSetting_if<SettingStringList, CustomComboBox>(setting);}},
-            {[&]{ return bindSetting_if<SettingFont, CustomFontButton>(setting);}},
-            {[&]{ return bindSetting_if<SettingColor, CustomColorButton>(setting);}},
-            {[&]{ return bindSetting_if<SettingSource, CustomSourceButton>(setting);}},
-            {[&]{ return bindSetting_if<SettingDateTime, CustomDateTimeEdit>(setting);}},
-            {[&]{ return bindSetting_if<SettingEditableStringList, CustomEditableListWidget>(setting);}},
-            {[&]{ return bindSetting_if<SettingChangeableStringList, CustomListBox>(setting);}},
-            {[&]{ return bindSetting_if<SettingCheckableStringList, CustomCheckableListWidget>(setting);}},
-        };
-
-        for (const auto& bindMethod : bindMethods)
-        {
-            if (bindMethod())
-            {
-                break;
-            }
-        }
+        (this->*bindMethod)(setting);
     }
 }
 
@@ -74,27 +53,9 @@ void CustomSettingWidget::setSetting(Setting *setting)
 
     setToolTip(setting->getDescription());
 
-    std::vector<std::function<bool()>> setMethods = {
-        {[&]{ return setSetting_if<SettingBool, CustomCheckBox>(setting);}},
-        {[&]{ return setSetting_if<SettingInt, CustomSpinBox>(setting);}},
-        {[&]{ return setSetting_if<SettingDouble, CustomDoubleSpinBox>(setting);}},
-        {[&]{ return setSetting_if<SettingString, CustomLineEdit>(setting);}},
-        {[&]{ return setSetting_if<SettingStringList, CustomComboBox>(setting);}},
-        {[&]{ return setSetting_if<SettingFont, CustomFontButton>(setting);}},
-        {[&]{ return setSetting_if<SettingColor, CustomColorButton>(setting);}},
-        {[&]{ return setSetting_if<SettingSource, CustomSourceButton>(setting);}},
-        {[&]{ return setSetting_if<SettingDateTime, CustomDateTimeEdit>(setting);}},
-        {[&]{ return setSetting_if<SettingEditableStringList, CustomEditableListWidget>(setting);}},
-        {[&]{ return setSetting_if<SettingChangeableStringList, CustomListBox>(setting);}},
-        {[&]{ return setSetting_if<SettingCheckableStringList, CustomCheckableListWidget>(setting);}},
-        };
-
-    for (const auto& setMethod : setMethods)
+    if (auto setMethod = getMethodTable().setMethods[int(setting->getTypeId())])
     {
-        if (setMethod())
-        {
-            break;
-        }
+        (this->*setMethod)(setting);
     }
 }
 
@@ -133,6 +94,28 @@ void CustomSettingWidget::clear()
     }
 }
 
+const CustomSettingWidget::SettingMethodTable& CustomSettingWidget::getMethodTable()
+{
+    static const SettingMethodTable table = [] {
+        SettingMethodTable methods{};
+        addMethods<SettingBool, CustomCheckBox>(methods);
+        addMethods<SettingInt, CustomSpinBox>(methods);
+        addMethods<SettingDouble, CustomDoubleSpinBox>(methods);
+        addMethods<SettingString, CustomLineEdit>(methods);
+        addMethods<SettingStringList, CustomComboBox>(methods);
+        addMethods<SettingFont, CustomFontButton>(methods);
+        addMethods<SettingColor, CustomColorButton>(methods);
+        addMethods<SettingSource, CustomSourceButton>(methods);
+        addMethods<SettingDateTime, CustomDateTimeEdit>(methods);
+        addMethods<SettingEditableStringList, CustomEditableListWidget>(methods);
+        addMethods<SettingChangeableStringList, CustomListBox>(methods);
+        addMethods<SettingCheckableStringList, CustomCheckableListWidget>(methods);
+        return methods;
+    }();
+
+    return table;
+}
+
 void CustomSettingWidget::applySizeHint()
 {
     if (mItemHeight > 0)
@@ -33,10 +33,10 @@ void CustomSpinBox::setSetting(SettingType* setting)
 {
     mSetting = setting;
 
-    setMinimum(mSetting->getData().minimum);
-    setMaximum(mSetting->getData().maximum);
-    setSuffix(mSetting->getData().suffix);
-    setValue(mSetting->getData().value);
+    setMinimum(mSetting->getSchema().minimum);
+    setMaximum(mSetting->getSchema().maximum);
+    setSuffix(mSetting->getSchema().suffix);
+    setValue(mSetting->getDataValue());
     setReadOnly(mSetting->isReadOnly());
 
     if (mSetting->isReadOnly())
@@ -54,7 +54,7 @@ void CustomSpinBox::onEditingFinished()
 void CustomSpinBox::onSettingDataChanged()
 {
     blockSignals(true);
-    setValue(mSetting->getData().value);
+    setValue(mSetting->getDataValue());
     blockSignals(false);
 }
 
@@ -81,8 +81,8 @@ void CustomSlider::setSetting(SettingType* setting)
 {
     mSetting = setting;
 
-    setMinimum(mSetting->getData().minimum);
-    setMaximum(mSetting->getData().maximum);
+    setMinimum(mSetting->getSchema().minimum);
+    setMaximum(mSetting->getSchema().maximum);
     setEnabled(!mSetting->isReadOnly());
 }
 
@@ -95,7 +95,7 @@ void CustomSlider::onEditingFinished()
 void CustomSlider::onSettingDataChanged()
 {
     blockSignals(true);
-    setValue(mSetting->getData().value);
+    setValue(mSetting->getDataValue());
     blockSignals(false);
 }
 
@@ -129,11 +129,11 @@ void CustomDoubleSpinBox::setSetting(SettingType* setting)
 {
     mSetting = setting;
 
-    setMinimum(mSetting->getData().minimum);
-    setMaximum(mSetting->getData().maximum);
-    setDecimals(mSetting->getData().decimals);
-    setSuffix(mSetting->getData().suffix);
-    setValue(mSetting->getData().value);
+    setMinimum(mSetting->getSchema().minimum);
+    setMaximum(mSetting->getSchema().maximum);
+    setDecimals(mSetting->getSchema().decimals);
+    setSuffix(mSetting->getSchema().suffix);
+    setValue(mSetting->getDataValue());
     setReadOnly(mSetting->isReadOnly());
 }
 
@@ -146,7 +146,7 @@ void CustomDoubleSpinBox::onEditingFinished()
 void CustomDoubleSpinBox::onSettingDataChanged()
 {
     blockSignals(true);
-    setValue(mSetting->getData().value);
+    setValue(mSetting->getDataValue());
     blockSignals(false);
 }
 
@@ -219,7 +219,7 @@ void CustomLineEdit::setSetting(SettingType* setting)
 
     setReadOnly(mSetting->isReadOnly());
 
-    const auto& regexString = mSetting->getData().regexValidatorString;
+    const auto& regexString = mSetting->getSchema().regexValidatorString;
     if (!regexString.isEmpty())
     {
         auto validator = new QRegExpValidator(QRegExp(regexString));
@@ -236,7 +236,7 @@ void CustomLineEdit::onEditingFinished()
 void CustomLineEdit::onSettingDataChanged()
 {
     blockSignals(true);
-    setText(mSetting->getData().value);
+    setText(mSetting->getDataValue());
     blockSignals(false);
 }
 
@@ -267,7 +267,7 @@ void CustomComboBox::setSetting(SettingType* setting)
 
     clear();
 
-    for (const auto& item : mSetting->getData().list)
+    for (const auto& item : mSetting->getSchema().list)
     {
         addItem(item);
     }
@@ -284,7 +284,7 @@ void CustomComboBox::onEditingFinished()
 void CustomComboBox::onSettingDataChanged()
 {
     blockSignals(true);
-    setCurrentText(mSetting->getData().value);
+    setCurrentText(mSetting->getDataValue());
     blockSignals(false);
 }
 
@@ -321,7 +321,7 @@ void CustomFontButton::setSetting(SettingType* setting)
 void CustomFontButton::onEditingFinished()
 {
     bool ok{false};
-    QFont fnt{QFontDialog::getFont(&ok, mSetting->getData().value)};
+    QFont fnt{QFontDialog::getFont(&ok, mSetting->getDataValue())};
 
     if (ok)
     {
@@ -333,7 +333,7 @@ void CustomFontButton::onEditingFinished()
 
 void CustomFontButton::onSettingDataChanged()
 {
-    setFont(mSetting->getData().value);
+    setFont(mSetting->getDataValue());
 }
 
 CustomColorButton::CustomColorButton(QWidget* parent) :
@@ -381,7 +381,7 @@ void CustomColorButton::onEditingFinished()
 void CustomColorButton::onSettingDataChanged()
 {
     setStyleSheet(
-        QString("background-color: %1;").arg(mSetting->getData().value.name()));
+        QString("background-color: %1;").arg(mSetting->getDataValue().name()));
 }
 
 CustomSourceButton::CustomSourceButton(QWidget* parent) :
@@ -417,7 +417,7 @@ void CustomSourceButton::onEditingFinished()
 {
     QString filename;
 
-    switch (mSetting->getData().sourceType)
+    switch (mSetting->getSchema().sourceType)
     {
         case DataSource::kDir:
             filename =
@@ -434,7 +434,7 @@ void CustomSourceButton::onEditingFinished()
                     this,
                     tr("Select file"),
                     "~/",
-                    mSetting->getData().filters);
+                    mSetting->getSchema().filters);
             break;
     }
 
@@ -448,7 +448,7 @@ void CustomSourceButton::onEditingFinished()
 
 void CustomSourceButton::onSettingDataChanged()
 {
-    setText(mSetting->getData().value);
+    setText(mSetting->getDataValue());
 }
 
 CustomListBox::CustomListBox(QWidget* parent) : QComboBox(parent), mSetting(nullptr)
@@ -489,7 +489,7 @@ void CustomListBox::onEditingFinished()
     {
         if (curText == addItemText)
         {
-            switch (mSetting->getData().listType)
+            switch (mSetting->getSchema().listType)
             {
                 case DataChangeableStringList::kStringList:
                     newCurrentText =
@@ -505,7 +505,7 @@ void CustomListBox::onEditingFinished()
                             this,
                             tr("Select file"),
                             "~/",
-                            mSetting->getData().filters);
+                            mSetting->getSchema().filters);
                     break;
                 case DataChangeableStringList::kDirList:
                     newCurrentText = QFileDialog::getExistingDirectory(
@@ -518,7 +518,7 @@ void CustomListBox::onEditingFinished()
             }
 
             if (mSetting->getDataValue().contains(newCurrentText) &&
-                mSetting->getData().isUniqItems)
+                mSetting->getSchema().isUniqItems)
             {
                 newCurrentText.clear();
             }
@@ -598,67 +598,74 @@ void CustomLabel::setSetting(SettingType* setting)
 
 void CustomLabel::onSettingDataChanged()
 {
-    if (auto boolSetting = dynamic_cast<SettingBool*>(mSetting))
+    if (!mSetting)
     {
-        setText(boolSetting->getData().value ? "+" : "-");
+        return;
     }
-    else if (auto intSetting = dynamic_cast<SettingInt*>(mSetting))
-    {
-        setText(QString("%1%2")
-                    .arg(intSetting->getData().value)
-                    .arg(intSetting->getData().suffix));
-    }
-    else if (auto doubleSetting = dynamic_cast<SettingDouble*>(mSetting))
-    {
-        setText(QString("%1%2")
-                    .arg(doubleSetting->getData().value)
-                    .arg(doubleSetting->getData().suffix));
-    }
-    else if (auto stringSetting = dynamic_cast<SettingString*>(mSetting))
-    {
-        setText(stringSetting->getData().value);
-    }
-    else if (auto listSetting = dynamic_cast<SettingStringList*>(mSetting))
+
+    switch (mSetting->getTypeId())
     {
-        setText(listSetting->getData().value);
-    }
-    else if (auto sourceSetting = dynamic_cast<SettingSource*>(mSetting))
+    case SettingTypeId::kBool:
     {
-        setText(sourceSetting->getData().value);
+        auto boolSetting = static_cast<SettingBool*>(mSetting);
+        setText(boolSetting->getDataValue() ? "+" : "-");
+        break;
     }
-    else if (auto changeableListSetting =
-                 dynamic_cast<SettingChangeableStringList*>(mSetting))
+    case SettingTypeId::kInt:
     {
-        setText(changeableListSetting->getData().value.at(0));
+        auto intSetting = static_cast<SettingInt*>(mSetting);
+        setText(QString("%1%2")
+                    .arg(intSetting->getDataValue())
+                    .arg(intSetting->getSchema().suffix));
+        break;
     }
-    else if (auto fontSetting = dynamic_cast<SettingFont*>(mSetting))
+    case SettingTypeId::kDouble:
     {
-        setFont(fontSetting->getData().value);
+        auto doubleSetting = static_cast<SettingDouble*>(mSetting);
+        setText(QString("%1%2")
+                    .arg(doubleSetting->getDataValue())
+                    .arg(doubleSetting->getSchema().suffix));
+        break;
+    }
+    case SettingTypeId::kString:
+        setText(static_cast<SettingString*>(mSetting)->getDataValue());
+        break;
+    case SettingTypeId::kStringList:
+        setText(static_cast<SettingStringList*>(mSetting)->getDataValue());
+        break;
+    case SettingTypeId::kSource:
+        setText(static_cast<SettingSource*>(mSetting)->getDataValue());
+        break;
+    case SettingTypeId::kChangeableStringList:
+        setText(static_cast<SettingChangeableStringList*>(mSetting)->getDataValue().at(0));
+        break;
+    case SettingTypeId::kFont:
+        setFont(static_cast<SettingFont*>(mSetting)->getDataValue());
         setText("Font");
-    }
-    else if(auto colorSetting = dynamic_cast<SettingColor*>(mSetting))
-    {
+        break;
+    case SettingTypeId::kColor:
         setStyleSheet(QString("background-color: %1;")
-                          .arg(colorSetting->getData().value.name()));
-    }
-    else if (auto editableListSetting =
-                 dynamic_cast<SettingEditableStringList*>(mSetting))
+                          .arg(static_cast<SettingColor*>(mSetting)->getDataValue().name()));
+        break;
+    case SettingTypeId::kEditableStringList:
     {
+        auto editableListSetting = static_cast<SettingEditableStringList*>(mSetting);
         QString str;
-        auto count = editableListSetting->getData().value.size();
-        for (const auto& value : editableListSetting->getData().value)
+        auto count = editableListSetting->getDataValue().size();
+        for (const auto& value : editableListSetting->getDataValue())
         {
             str += value + (count > 1 ? "\n" : "");
             count--;
         }
         setText(str);
+        break;
     }
-    else if (auto checkablebleListSetting =
-                 dynamic_cast<SettingCheckableStringList*>(mSetting))
+    case SettingTypeId::kCheckableStringList:
     {
+        auto checkablebleListSetting = static_cast<SettingCheckableStringList*>(mSetting);
         QString str;
-        auto count = checkablebleListSetting->getData().list.size();
-        for (const auto& value : checkablebleListSetting->getData().list)
+        auto count = checkablebleListSetting->getSchema().list.size();
+        for (const auto& value : checkablebleListSetting->getSchema().list)
         {
             str += checkablebleListSetting->getDataValue().contains(value)
                        ? "[+] "
@@ -667,10 +674,13 @@ void CustomLabel::onSettingDataChanged()
             count--;
         }
         setText(str);
+        break;
     }
-    else if (auto dateTimeSetting = dynamic_cast<SettingDateTime*>(mSetting))
-    {
-        setText(dateTimeSetting->getDataValue().toString());
+    case SettingTypeId::kDateTime:
+        setText(static_cast<SettingDateTime*>(mSetting)->getDataValue().toString());
+        break;
+    default:
+        break;
     }
 }
 
@@ -840,7 +850,7 @@ void CustomCheckableListWidget::onSettingDataChanged()
     blockSignals(true);
 
     mListWidget->clear();
-    mListWidget->addItems(mSetting->getData().list);
+    mListWidget->addItems(mSetting->getSchema().list);
 
     for(int i = 0; i < mListWidget->count(); ++i)
     {